@@ -6,6 +6,13 @@
 #include <array>
 #include "src/arg_parser.h"
 #include "src/file_processor.h"
+#include "src/pattern_cluster.h"
+#include "src/query_batch.h"
+#include "src/daemon.h"
+#include "src/checkpoint.h"
+#include "src/estimate.h"
+#include "src/pack.h"
+#include <string_view>
 
 /**
  * High-performance log parser with grep-style pattern matching,
@@ -29,6 +36,14 @@
  * - Log format configuration (-f, --log-format flag).
  * - Grep-style context lines (-A, -B, -C flags).
  * - ANSI color-coded output based on log severity levels.
+ * - Level filter (--level) and per-query output files (-o).
+ * - JSON Lines / binary match records (--output).
+ * - Many queries in one shared scan (--query-file).
+ * - Message template clustering (--patterns, --top, --threads).
+ * - Resident query daemon over a Unix socket (serve / query subcommands).
+ * - Incremental scans of appended data (--checkpoint, --since-last).
+ * - Sampling-based match count estimate (--estimate, --budget-ms, --budget-mb).
+ * - Block-compressed, indexed .lpk archives (pack subcommand; searched like logs).
  * 
  * @author Onur Aydoğan
  * @version 1.5
@@ -40,7 +55,38 @@ int main(int argc, char* argv[])
 
     try
     {
+        if (argc > 1 && (std::string_view(argv[1]) == "serve" || std::string_view(argv[1]) == "query"))
+        {
+            return run_daemon_command(argc, argv);
+        }
+        if (argc > 1 && std::string_view(argv[1]) == "pack")
+        {
+            return run_pack_command(argc, argv);
+        }
+
         ProgramOptions options = parse_arguments(argc, argv);
+
+        if (is_pack_file(options.inputFilePath))
+        {
+            return search_pack(options);
+        }
+
+        if (!options.queryFilePath.empty())
+        {
+            return run_query_file(options);
+        }
+        if (options.patternsMode)
+        {
+            return cluster_patterns(options);
+        }
+        if (options.estimateMode)
+        {
+            return estimate_matches(options);
+        }
+        if (!options.checkpointPath.empty())
+        {
+            return search_since_checkpoint(options);
+        }
         return search_in_file(options);
     }
 
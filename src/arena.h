@@ -0,0 +1,79 @@
+// src/arena.h
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+constexpr size_t ARENA_BLOCK_SIZE {64 * 1024};
+
+/**
+ * Bump-pointer arena allocator.
+ * Memory is handed out from large blocks and only released all at once
+ * when the arena is destroyed, so many small allocations cost one pointer bump each.
+ *
+ * Not thread-safe: use one arena per thread (e.g. one per TemplateTable).
+ */
+class Arena
+{
+public:
+    Arena() = default;
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&&) noexcept = default;
+    Arena& operator=(Arena&&) noexcept = default;
+
+    /**
+     * Allocates uninitialized, byte-aligned storage that lives as long as the arena.
+     * Requests larger than a block get their own dedicated block.
+     *
+     * @param bytes Number of bytes to allocate.
+     * @return Pointer to the storage (never nullptr).
+     */
+    char* allocate(size_t bytes)
+    {
+        if (bytes > m_remaining)
+        {
+            size_t blockSize {bytes > ARENA_BLOCK_SIZE ? bytes : ARENA_BLOCK_SIZE};
+            m_blocks.push_back(std::make_unique_for_overwrite<char[]>(blockSize));
+            m_cursor = m_blocks.back().get();
+            m_remaining = blockSize;
+            m_bytesReserved += blockSize;
+        }
+
+        char* result {m_cursor};
+        m_cursor += bytes;
+        m_remaining -= bytes;
+        return result;
+    }
+
+    /**
+     * Copies a string into the arena.
+     *
+     * @param text Bytes to copy.
+     * @return View of the arena-owned copy.
+     */
+    std::string_view store(std::string_view text)
+    {
+        char* dest {allocate(text.size())};
+        if (!text.empty())
+        {
+            std::memcpy(dest, text.data(), text.size());
+        }
+        return {dest, text.size()};
+    }
+
+    size_t bytes_reserved() const { return m_bytesReserved; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    char* m_cursor {nullptr};
+    size_t m_remaining {0};
+    size_t m_bytesReserved {0};
+};
+
+#endif // ARENA_H
@@ -7,7 +7,12 @@ ProgramOptions parse_arguments(int argc, char* argv[])
     if (argc <= MIN_REQUIRED_ARGS)
     {
         throw std::runtime_error("Usage: " + std::string(argv[0]) + 
-                                " <input_file> <search_pattern1> [search_pattern2 ...] [-f/--log-format] [<log_format>] [-i] [-r] [-from <date>] [-to <date>]");
+                                " <input_file> <search_pattern1> [search_pattern2 ...] [-f/--log-format] [<log_format>] [-i] [-r] [-from <date>] [-to <date>]"
+                                " [--level <levels>] [-o <output_file>] [--output text|jsonl|binary] [--checkpoint <state_file> [--since-last]]"
+                                " | <input_file> --query-file <queries>"
+                                " | <input_file> <search_pattern1> ... --estimate [--budget-ms <ms>] [--budget-mb <mb>]"
+                                " | <input_file> --patterns [filter_pattern ...] [--top <k>] [--threads <n>]"
+                                " | pack <input_file> <output.lpk> [--threads <n>]");
     }
     
     ProgramOptions options;
@@ -36,8 +41,7 @@ ProgramOptions parse_arguments(int argc, char* argv[])
                 throw std::runtime_error("Missing value after -from flag.");
             }
             std::string dateStr {argv[++i]};
-            auto frmt = detect_date_format(dateStr);
-            auto parsed = parse_log_timestamp(dateStr, frmt);
+            auto parsed = parse_timestamp(dateStr);
             if (!parsed)
             {
                 throw std::runtime_error("Invalid date format for -from: " + dateStr);
@@ -52,8 +56,7 @@ ProgramOptions parse_arguments(int argc, char* argv[])
                 throw std::runtime_error("Missing value after -to flag.");
             }
             std::string dateStr {argv[++i]};
-            auto frmt = detect_date_format(dateStr);
-            auto parsed = parse_log_timestamp(dateStr, frmt);
+            auto parsed = parse_timestamp(dateStr);
             if (!parsed)
             {
                 throw std::runtime_error("Invalid date format for -to: " + dateStr);
@@ -148,13 +151,224 @@ ProgramOptions parse_arguments(int argc, char* argv[])
             }
         }
 
+        else if (arg == "--level")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --level flag.");
+            }
+
+            // comma separated list, e.g. "error,fatal"
+            std::string levels {argv[++i]};
+            options.levelMask = 0;
+            size_t start {0};
+            while (start <= levels.size())
+            {
+                size_t comma {levels.find(',', start)};
+                if (comma == std::string::npos)
+                    comma = levels.size();
+
+                auto level = parse_log_level(std::string_view(levels).substr(start, comma - start));
+                if (!level)
+                {
+                    throw std::runtime_error("Unknown log level in --level: " + levels);
+                }
+                options.levelMask |= log_level_bit(*level);
+                start = comma + 1;
+            }
+        }
+
+        else if (arg == "-o" || arg == "--output-file")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after -o/--output-file flag.");
+            }
+            options.outputFilePath = argv[++i];
+        }
+
+        else if (arg == "--output")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --output flag.");
+            }
+
+            std::string format {argv[++i]};
+            if (format == "text")
+                options.outputFormat = OutputFormat::TEXT;
+            else if (format == "jsonl")
+                options.outputFormat = OutputFormat::JSONL;
+            else if (format == "binary")
+                options.outputFormat = OutputFormat::BINARY;
+            else
+                throw std::runtime_error("Unknown output format: " + format + " (expected text, jsonl or binary)");
+        }
+
+        else if (arg == "--query-file")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --query-file flag.");
+            }
+            options.queryFilePath = argv[++i];
+        }
+
+        else if (arg == "--patterns")
+        {
+            options.patternsMode = true;
+        }
+
+        else if (arg == "--top")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --top flag.");
+            }
+
+            try
+            {
+                options.topPatterns = std::stoi(argv[++i]);
+            }
+
+            catch (const std::exception&)
+            {
+                throw std::runtime_error("Invalid integer value for --top flag: " + std::string(argv[i]));
+            }
+
+            if (options.topPatterns <= 0)
+            {
+                throw std::runtime_error("Top (--top) value must be positive.");
+            }
+        }
+
+        else if (arg == "--threads")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --threads flag.");
+            }
+
+            try
+            {
+                options.threads = std::stoi(argv[++i]);
+            }
+
+            catch (const std::exception&)
+            {
+                throw std::runtime_error("Invalid integer value for --threads flag: " + std::string(argv[i]));
+            }
+
+            if (options.threads < 0)
+            {
+                throw std::runtime_error("Threads (--threads) value must be non-negative.");
+            }
+        }
+
+        else if (arg == "--estimate")
+        {
+            options.estimateMode = true;
+        }
+
+        else if (arg == "--budget-ms")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --budget-ms flag.");
+            }
+
+            try
+            {
+                options.estimateBudgetMs = std::stoi(argv[++i]);
+            }
+
+            catch (const std::exception&)
+            {
+                throw std::runtime_error("Invalid integer value for --budget-ms flag: " + std::string(argv[i]));
+            }
+
+            if (options.estimateBudgetMs <= 0)
+            {
+                throw std::runtime_error("Budget (--budget-ms) value must be positive.");
+            }
+        }
+
+        else if (arg == "--budget-mb")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --budget-mb flag.");
+            }
+
+            try
+            {
+                options.estimateBudgetMb = std::stoi(argv[++i]);
+            }
+
+            catch (const std::exception&)
+            {
+                throw std::runtime_error("Invalid integer value for --budget-mb flag: " + std::string(argv[i]));
+            }
+
+            if (options.estimateBudgetMb <= 0)
+            {
+                throw std::runtime_error("Budget (--budget-mb) value must be positive.");
+            }
+        }
+
+        else if (arg == "--checkpoint")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --checkpoint flag.");
+            }
+            options.checkpointPath = argv[++i];
+        }
+
+        else if (arg == "--since-last")
+        {
+            options.sinceLast = true;
+        }
+
         else
         {
             options.searchPatterns.push_back(arg);
         }
     }
 
-    if (options.searchPatterns.empty())
+    if (options.sinceLast && options.checkpointPath.empty())
+    {
+        throw std::runtime_error("--since-last requires --checkpoint <state_file>.");
+    }
+    if (options.estimateMode && (options.patternsMode || !options.queryFilePath.empty()
+                                 || !options.checkpointPath.empty() || options.outputFormat != OutputFormat::TEXT))
+    {
+        throw std::runtime_error("--estimate cannot be combined with --patterns, --query-file, --checkpoint or --output.");
+    }
+    if (options.outputFormat != OutputFormat::TEXT && options.patternsMode)
+    {
+        throw std::runtime_error("--output jsonl/binary cannot be combined with --patterns.");
+    }
+    if (!options.queryFilePath.empty()
+        && (!options.searchPatterns.empty() || options.caseInsensitive || options.useRegex || options.fromTime
+            || options.toTime || options.beforeContext > 0 || options.afterContext > 0
+            || options.levelMask != ALL_LOG_LEVELS_MASK || !options.outputFilePath.empty()
+            || options.outputFormat != OutputFormat::TEXT || !(options.logFormat == DEFAULT_LOG_LEVEL_CONFIG)))
+    {
+        throw std::runtime_error("--query-file takes patterns and search options from the query file only.");
+    }
+    if (options.patternsMode && (options.beforeContext > 0 || options.afterContext > 0))
+    {
+        throw std::runtime_error("-A/-B/-C cannot be combined with --patterns.");
+    }
+    if (!options.checkpointPath.empty() && (options.patternsMode || !options.queryFilePath.empty()))
+    {
+        throw std::runtime_error("--checkpoint cannot be combined with --patterns or --query-file.");
+    }
+
+    // --patterns clusters every line when no filter pattern is given,
+    // --query-file takes its patterns from the query file
+    if (options.searchPatterns.empty() && !options.patternsMode && options.queryFilePath.empty())
     {
         throw std::runtime_error("No search pattern(s) provided. At least one pattern is required.");
     }
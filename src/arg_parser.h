@@ -14,6 +14,17 @@
 
 constexpr int MIN_REQUIRED_ARGS {2};
 constexpr int FIRST_PATTERN_ARG_INDEX {2};
+constexpr int DEFAULT_TOP_PATTERNS {20};
+constexpr int DEFAULT_ESTIMATE_BUDGET_MS {300};
+constexpr int DEFAULT_ESTIMATE_BUDGET_MB {64};
+
+// Match output format (--output)
+enum class OutputFormat
+{
+    TEXT,   // colored "[level:Lnum] line" (default)
+    JSONL,  // one JSON object per line
+    BINARY  // length-prefixed records (see record_format.h)
+};
 
 /**
  * Command-line program options structure (parsed from argv).
@@ -33,12 +44,41 @@ struct ProgramOptions
     // log format config (-f, --log-format flag)
     LogLevelConfig logFormat {DEFAULT_LOG_LEVEL_CONFIG};
 
-    // cache detected date format to avoid re-detection (optimizes regex)
-    LogDateFormat detectedDateFormat {LogDateFormat::UNKNOWN};
+    // timestamp layout detected once per log (see detect_timestamp_layout())
+    TimestampLayout detectedDateFormat {};
 
     // context lines (grep-style): -B (before), -A (after), -C (both)
     int beforeContext {0}; 
     int afterContext {0};  
+
+    // level filter (--level error,fatal), bit set of LogLevel values
+    unsigned levelMask {ALL_LOG_LEVELS_MASK};
+
+    // match destination (-o, --output-file), empty = stdout
+    std::string outputFilePath;
+
+    // match record format (--output text|jsonl|binary)
+    OutputFormat outputFormat {OutputFormat::TEXT};
+
+    // batch mode: one query per line, all evaluated in one scan (--query-file)
+    std::string queryFilePath;
+
+    // message template clustering (--patterns, --top)
+    bool patternsMode {false};
+    int topPatterns {DEFAULT_TOP_PATTERNS};
+
+    // worker threads for parallel scans (--threads), 0 = one per hardware thread
+    int threads {0};
+
+    // incremental scans: state file recorded after the scan (--checkpoint),
+    // resume from it instead of scanning the whole file (--since-last)
+    std::string checkpointPath;
+    bool sinceLast {false};
+
+    // sampling estimate of the match count (--estimate) within a time / byte budget
+    bool estimateMode {false};
+    int estimateBudgetMs {DEFAULT_ESTIMATE_BUDGET_MS};
+    int estimateBudgetMb {DEFAULT_ESTIMATE_BUDGET_MB};
 };
 
 /**
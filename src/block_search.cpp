@@ -0,0 +1,203 @@
+// src/block_search.cpp
+
+#include "block_search.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    constexpr size_t SSE_WIDTH {16};
+    constexpr size_t MAX_SAD_ITERATIONS {255}; // byte lanes overflow after 255 increments
+
+    inline char fold_ascii(char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    inline char upper_ascii(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+}
+
+size_t count_newlines(const char* begin, const char* end)
+{
+    size_t count {0};
+    const char* p {begin};
+
+#ifdef __SSE2__
+    const __m128i newline {_mm_set1_epi8('\n')};
+    const __m128i zero {_mm_setzero_si128()};
+
+    while (static_cast<size_t>(end - p) >= SSE_WIDTH)
+    {
+        // Accumulate per-lane counts (cmpeq yields -1 per hit), flush with SAD before overflow
+        __m128i lanes {_mm_setzero_si128()};
+        size_t iterations {std::min(MAX_SAD_ITERATIONS, static_cast<size_t>(end - p) / SSE_WIDTH)};
+
+        for (size_t k = 0; k < iterations; ++k, p += SSE_WIDTH)
+        {
+            __m128i chunk {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+            lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(chunk, newline));
+        }
+
+        __m128i sums {_mm_sad_epu8(lanes, zero)};
+        count += static_cast<size_t>(_mm_cvtsi128_si64(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+    }
+#endif
+
+    count += static_cast<size_t>(std::count(p, end, '\n'));
+    return count;
+}
+
+LiteralSearcher::LiteralSearcher(std::string needle, bool caseInsensitive)
+    : m_needle {std::move(needle)},
+      m_caseInsensitive {caseInsensitive}
+{
+    if (m_caseInsensitive)
+    {
+        std::transform(m_needle.begin(), m_needle.end(), m_needle.begin(), fold_ascii);
+    }
+}
+
+bool LiteralSearcher::equals_at(const char* position) const
+{
+    if (!m_caseInsensitive)
+    {
+        return std::memcmp(position, m_needle.data(), m_needle.size()) == 0;
+    }
+
+    for (size_t k = 0; k < m_needle.size(); ++k)
+    {
+        if (fold_ascii(position[k]) != m_needle[k])
+            return false;
+    }
+    return true;
+}
+
+const char* LiteralSearcher::find(const char* begin, const char* end) const
+{
+    size_t n {m_needle.size()};
+    if (n == 0)
+    {
+        return begin;
+    }
+    if (static_cast<size_t>(end - begin) < n)
+    {
+        return nullptr;
+    }
+
+    if (!m_caseInsensitive && n == 1)
+    {
+        return static_cast<const char*>(memchr(begin, m_needle[0], end - begin));
+    }
+
+    const char* p {begin};
+    const char* lastStart {end - n}; // last valid start position
+
+#ifdef __SSE2__
+    // "Generic SIMD" substring search: test first and last byte at 16 starts per step
+    const __m128i firstByte {_mm_set1_epi8(m_needle.front())};
+    const __m128i firstOtherCase {_mm_set1_epi8(upper_ascii(m_needle.front()))};
+    const __m128i lastByte {_mm_set1_epi8(m_needle.back())};
+    const __m128i lastOtherCase {_mm_set1_epi8(upper_ascii(m_needle.back()))};
+
+    while (p + SSE_WIDTH <= lastStart + 1)
+    {
+        __m128i firstBlock {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))};
+        __m128i lastBlock {_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + n - 1))};
+
+        __m128i firstEq {_mm_cmpeq_epi8(firstBlock, firstByte)};
+        __m128i lastEq {_mm_cmpeq_epi8(lastBlock, lastByte)};
+        if (m_caseInsensitive)
+        {
+            firstEq = _mm_or_si128(firstEq, _mm_cmpeq_epi8(firstBlock, firstOtherCase));
+            lastEq = _mm_or_si128(lastEq, _mm_cmpeq_epi8(lastBlock, lastOtherCase));
+        }
+
+        unsigned mask {static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(firstEq, lastEq)))};
+        while (mask != 0)
+        {
+            const char* candidate {p + std::countr_zero(mask)};
+            if (equals_at(candidate))
+            {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+        p += SSE_WIDTH;
+    }
+#endif
+
+    for (; p <= lastStart; ++p)
+    {
+        if (equals_at(p))
+        {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<CandidateFinder> CandidateFinder::create(const LineMatcher& matcher)
+{
+    auto literals {matcher.required_literals()};
+    if (!literals || literals->empty())
+    {
+        return std::nullopt;
+    }
+
+    CandidateFinder finder;
+    if (literals->size() <= MAX_SEPARATE_LITERALS)
+    {
+        for (const auto& literal : *literals)
+        {
+            finder.m_searchers.emplace_back(literal, matcher.case_insensitive());
+        }
+        finder.m_nextHit.assign(literals->size(), nullptr);
+        finder.m_hitValid.assign(literals->size(), false);
+    }
+    else
+    {
+        for (const auto& literal : *literals)
+        {
+            finder.m_lengths.push_back(literal.size());
+        }
+        finder.m_multi = MultiPatternMatcher(*literals, matcher.case_insensitive());
+    }
+    return finder;
+}
+
+const char* CandidateFinder::find(const char* begin, const char* end)
+{
+    if (!m_searchers.empty())
+    {
+        // Each literal scans the buffer at most once overall: hits before begin are refreshed
+        const char* leftmost {nullptr};
+        for (size_t i = 0; i < m_searchers.size(); ++i)
+        {
+            if (!m_hitValid[i] || (m_nextHit[i] != nullptr && m_nextHit[i] < begin))
+            {
+                m_nextHit[i] = m_searchers[i].find(begin, end);
+                m_hitValid[i] = true;
+            }
+            if (m_nextHit[i] != nullptr && (leftmost == nullptr || m_nextHit[i] < leftmost))
+            {
+                leftmost = m_nextHit[i];
+            }
+        }
+        return leftmost;
+    }
+
+    const char* hit {nullptr};
+    m_multi.scan(std::string_view(begin, end - begin), [&](uint32_t pattern, size_t endOffset) {
+        hit = begin + endOffset - m_lengths[pattern];
+        return false;
+    });
+    return hit;
+}
@@ -0,0 +1,82 @@
+// src/block_search.h
+
+#ifndef BLOCK_SEARCH_H
+#define BLOCK_SEARCH_H
+
+#include "matcher.h"
+#include "multi_pattern.h"
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+constexpr size_t MAX_SEPARATE_LITERALS {8}; // above this, one automaton pass beats k searches
+
+/**
+ * Counts '\n' bytes in [begin, end) using SSE2 compares (16 bytes per step),
+ * falling back to a scalar loop where SSE2 is unavailable.
+ *
+ * @param begin Start of the range.
+ * @param end One past the end of the range.
+ * @return Number of newlines in the range.
+ */
+size_t count_newlines(const char* begin, const char* end);
+
+/**
+ * Single-literal block searcher.
+ * Compares the first and last needle byte against 16 candidate positions at once
+ * (SSE2) and only verifies positions where both agree, which skips most of the
+ * buffer without touching line structure. Supports ASCII case folding.
+ */
+class LiteralSearcher
+{
+public:
+    LiteralSearcher(std::string needle, bool caseInsensitive);
+
+    /**
+     * @return Pointer to the first occurrence in [begin, end), or nullptr.
+     */
+    const char* find(const char* begin, const char* end) const;
+
+private:
+    bool equals_at(const char* position) const;
+
+    std::string m_needle; // folded to lowercase if case-insensitive
+    bool m_caseInsensitive {false};
+};
+
+/**
+ * Finds candidate match positions directly in a large buffer (buffer-level search).
+ * Built from LineMatcher::required_literals(): a few literals each get a
+ * LiteralSearcher (next hit per literal cached, leftmost reported), larger sets
+ * use the Aho-Corasick automaton. Candidates are a superset of matches; the
+ * enclosing line must still be verified with LineMatcher::matches().
+ *
+ * Stateful: successive find() calls must use non-decreasing begin and the same end.
+ */
+class CandidateFinder
+{
+public:
+    /**
+     * @param matcher Compiled search patterns.
+     * @return A finder, or std::nullopt if the patterns have no required literal
+     *         (every line is a candidate, buffer-level search does not apply).
+     */
+    static std::optional<CandidateFinder> create(const LineMatcher& matcher);
+
+    /**
+     * @return Pointer to the start of the first candidate hit in [begin, end), or nullptr.
+     */
+    const char* find(const char* begin, const char* end);
+
+private:
+    CandidateFinder() = default;
+
+    std::vector<LiteralSearcher> m_searchers;
+    std::vector<const char*> m_nextHit;   // cached hit per searcher (nullptr = none left)
+    std::vector<bool> m_hitValid;         // cache entry computed for the current range
+    MultiPatternMatcher m_multi;
+    std::vector<size_t> m_lengths;        // literal lengths for the multi-pattern case
+};
+
+#endif // BLOCK_SEARCH_H
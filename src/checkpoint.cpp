@@ -0,0 +1,303 @@
+// src/checkpoint.cpp
+
+#include "checkpoint.h"
+#include "file_processor.h"
+#include <filesystem>
+
+namespace
+{
+    // A file mapped from a checkpoint offset, with the fingerprint bytes kept in front of it
+    struct MappedTail
+    {
+        MappedFile file;
+        size_t prefixSize {0};
+
+        std::string_view tail() const { return file.view().substr(prefixSize); }
+    };
+
+    // Maps `path` after the checkpoint, or std::nullopt if its bytes before the offset differ
+    std::optional<MappedTail> map_after_checkpoint(const std::string& path, const Checkpoint& checkpoint)
+    {
+        size_t prefixSize {std::min(CHECKPOINT_FINGERPRINT_SIZE, static_cast<size_t>(checkpoint.offset))};
+        MappedTail mapped {MappedFile(path, checkpoint.offset - static_cast<off_t>(prefixSize)), prefixSize};
+
+        std::string_view view {mapped.file.view()};
+        if (view.size() < prefixSize || fnv1a_hash(view.substr(0, prefixSize)) != checkpoint.fingerprint)
+        {
+            return std::nullopt;
+        }
+        return mapped;
+    }
+
+    /*
+    * Rotated predecessor of the log: a sibling named <log>.1, <log>-20251021 ...
+    * that still has the recorded inode (rename rotation) or, failing that, whose
+    * bytes before the offset match the fingerprint (copytruncate rotation).
+    */
+    std::optional<MappedTail> find_rotated_predecessor(const std::string& logPath, const Checkpoint& checkpoint)
+    {
+        std::filesystem::path log {logPath};
+        std::string prefix {log.filename().string()};
+
+        std::vector<std::string> siblings;
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(log.parent_path(), error))
+        {
+            std::string name {entry.path().filename().string()};
+            if (name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0)
+            {
+                siblings.push_back(entry.path().string());
+            }
+        }
+        std::sort(siblings.begin(), siblings.end()); // <log>.1 before <log>.2
+
+        std::vector<std::string> fingerprintCandidates;
+        for (const auto& sibling : siblings)
+        {
+            struct stat sb;
+            if (stat(sibling.c_str(), &sb) == -1 || !S_ISREG(sb.st_mode) || sb.st_size < checkpoint.offset)
+            {
+                continue;
+            }
+
+            if (sb.st_dev == checkpoint.device && sb.st_ino == checkpoint.inode)
+            {
+                if (auto mapped {map_after_checkpoint(sibling, checkpoint)})
+                {
+                    return mapped;
+                }
+                continue; // inode reused by another file: fall back to the content fingerprint
+            }
+            fingerprintCandidates.push_back(sibling);
+        }
+
+        for (const auto& candidate : fingerprintCandidates)
+        {
+            if (auto mapped {map_after_checkpoint(candidate, checkpoint)})
+            {
+                return mapped;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // Complete lines only: a line still being written is left for the next run
+    std::string_view complete_lines(std::string_view data)
+    {
+        size_t lastNewline {data.rfind('\n')};
+        return lastNewline == std::string_view::npos ? std::string_view {} : data.substr(0, lastNewline + 1);
+    }
+}
+
+std::optional<Checkpoint> load_checkpoint(const std::string& statePath)
+{
+    std::ifstream state(statePath);
+    if (!state)
+    {
+        return std::nullopt; // first run
+    }
+
+    Checkpoint checkpoint;
+    int fieldsRead {0};
+    std::string line;
+
+    try
+    {
+        while (std::getline(state, line))
+        {
+            size_t separator {line.find('=')};
+            if (line.empty() || line[0] == '#' || separator == std::string::npos)
+            {
+                continue;
+            }
+
+            std::string key {line.substr(0, separator)};
+            std::string value {line.substr(separator + 1)};
+
+            if (key == "path")
+                checkpoint.logPath = value;
+            else if (key == "device")
+                checkpoint.device = static_cast<dev_t>(std::stoull(value));
+            else if (key == "inode")
+                checkpoint.inode = static_cast<ino_t>(std::stoull(value));
+            else if (key == "offset")
+                checkpoint.offset = static_cast<off_t>(std::stoll(value));
+            else if (key == "line")
+                checkpoint.lineNumber = std::stoi(value);
+            else if (key == "fingerprint")
+                checkpoint.fingerprint = std::stoull(value, nullptr, 16);
+            else if (key == "layout") // optional: absent until detected
+            {
+                int format {std::stoi(value)};
+                checkpoint.layout.emplace().format = format >= 0 && format < static_cast<int>(LogDateFormat::UNKNOWN)
+                    ? static_cast<LogDateFormat>(format)
+                    : LogDateFormat::UNKNOWN;
+                continue;
+            }
+            else if (key == "layout_column") // optional, follows layout
+            {
+                if (checkpoint.layout)
+                    checkpoint.layout->column = static_cast<uint16_t>(std::stoul(value));
+                continue;
+            }
+            else
+                continue;
+
+            ++fieldsRead;
+        }
+    }
+
+    catch (const std::exception&)
+    {
+        throw std::runtime_error("Malformed checkpoint file: " + statePath + " (" + line + ")");
+    }
+
+    if (fieldsRead < 6 || checkpoint.offset < 0 || checkpoint.lineNumber < 0)
+    {
+        throw std::runtime_error("Malformed checkpoint file: " + statePath);
+    }
+    return checkpoint;
+}
+
+void save_checkpoint(const std::string& statePath, const Checkpoint& checkpoint)
+{
+    std::string temporaryPath {statePath + ".tmp"};
+
+    {
+        std::ofstream state(temporaryPath, std::ios::out | std::ios::trunc);
+        state << "# logparser checkpoint\n"
+              << "path=" << checkpoint.logPath << '\n'
+              << "device=" << checkpoint.device << '\n'
+              << "inode=" << checkpoint.inode << '\n'
+              << "offset=" << checkpoint.offset << '\n'
+              << "line=" << checkpoint.lineNumber << '\n';
+        if (checkpoint.layout)
+        {
+            state << "layout=" << static_cast<int>(checkpoint.layout->format) << '\n'
+                  << "layout_column=" << checkpoint.layout->column << '\n';
+        }
+        state << "fingerprint=" << std::hex << checkpoint.fingerprint << '\n';
+
+        if (!state.flush())
+        {
+            throw std::runtime_error("Failed to write checkpoint file: " + temporaryPath);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, statePath, error);
+    if (error)
+    {
+        throw std::runtime_error("Failed to write checkpoint file: " + statePath + " (" + error.message() + ")");
+    }
+}
+
+int search_since_checkpoint(const ProgramOptions& options)
+{
+    std::string logPath {std::filesystem::absolute(options.inputFilePath).lexically_normal().string()};
+
+    struct stat current;
+    if (stat(logPath.c_str(), &current) == -1)
+    {
+        throw std::runtime_error("Failed to open file: " + options.inputFilePath);
+    }
+
+    std::optional<Checkpoint> previous;
+    if (options.sinceLast)
+    {
+        previous = load_checkpoint(options.checkpointPath);
+        if (previous && previous->logPath != logPath)
+        {
+            throw std::runtime_error("Checkpoint " + options.checkpointPath + " belongs to another log: " + previous->logPath);
+        }
+    }
+
+    // Match destination (-o flag), stdout by default
+    std::ofstream outputFile;
+    std::ostream& out {open_output(options.outputFilePath, outputFile)};
+
+    std::vector<LogSegment> segments;
+    std::optional<MappedTail> predecessor;
+    std::optional<MappedTail> continued;
+
+    if (previous)
+    {
+        if (current.st_dev == previous->device && current.st_ino == previous->inode && current.st_size >= previous->offset)
+        {
+            continued = map_after_checkpoint(logPath, *previous);
+        }
+
+        if (!continued)
+        {
+            // Rotated or truncated: finish the predecessor (including an unterminated last line) first
+            predecessor = find_rotated_predecessor(logPath, *previous);
+            if (predecessor)
+            {
+                segments.push_back({predecessor->tail(), previous->lineNumber + 1, static_cast<uint64_t>(previous->offset)});
+            }
+            else
+            {
+                std::cerr << "Warning: " << options.inputFilePath
+                          << " was rotated or truncated and its previous content was not found; scanning it from the start." << std::endl;
+            }
+        }
+    }
+
+    // New data of the current file: after the checkpoint, or all of it
+    MappedTail scanned {continued ? std::move(*continued) : MappedTail {MappedFile(logPath), 0}};
+    off_t startOffset {continued ? previous->offset : 0};
+    int startLine {continued ? previous->lineNumber : 0};
+
+    std::string_view newLines {complete_lines(scanned.tail())};
+    segments.push_back({newLines, startLine + 1, static_cast<uint64_t>(startOffset)});
+
+    // Layout from the state file, else from the head of the log (an appended tail may start with
+    // undated lines), only when dates are filtered or written; a rotated log may gain timestamps
+    std::optional<TimestampLayout> layout {previous ? previous->layout : std::nullopt};
+    if (!continued && layout && !layout->known())
+    {
+        layout.reset();
+    }
+
+    bool needsLayout {options.fromTime || options.toTime || options.outputFormat != OutputFormat::TEXT};
+    if (needsLayout && !layout)
+    {
+        MappedFile file(logPath, 0, AccessPattern::RANDOM);
+        std::string_view head {file.view().substr(0, CHECKPOINT_LAYOUT_HEAD_SIZE)};
+        TimestampLayout detected {detect_timestamp_layout(head)};
+
+        // "No timestamps" is only final once the head can no longer grow
+        if (detected.known() || head.size() == CHECKPOINT_LAYOUT_HEAD_SIZE
+            || count_newlines(head.data(), head.data() + head.size()) >= DATE_DETECTION_MAX_LINES)
+        {
+            layout = detected;
+        }
+    }
+
+    ProgramOptions scanOptions {options};
+    scanOptions.detectedDateFormat = layout.value_or(TimestampLayout {});
+
+    LineMatcher matcher(scanOptions);
+    search_segments(segments, scanOptions, matcher, out, std::cerr);
+
+    if (!out.flush())
+    {
+        throw std::runtime_error("Failed to write matches; checkpoint not updated.");
+    }
+
+    // Fingerprint = bytes right before the new offset (the prefix keeps them mapped)
+    std::string_view mapped {scanned.file.view().substr(0, scanned.prefixSize + newLines.size())};
+    size_t fingerprintSize {std::min(CHECKPOINT_FINGERPRINT_SIZE, mapped.size())};
+
+    Checkpoint next;
+    next.logPath = logPath;
+    next.device = current.st_dev;
+    next.inode = current.st_ino;
+    next.offset = startOffset + static_cast<off_t>(newLines.size());
+    next.lineNumber = startLine + static_cast<int>(count_newlines(newLines.data(), newLines.data() + newLines.size()));
+    next.fingerprint = fnv1a_hash(mapped.substr(mapped.size() - fingerprintSize));
+    next.layout = layout;
+    save_checkpoint(options.checkpointPath, next);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,69 @@
+// src/checkpoint.h
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "arg_parser.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <sys/types.h>
+
+constexpr size_t CHECKPOINT_FINGERPRINT_SIZE {64}; // bytes right before the offset that identify the file content
+constexpr size_t CHECKPOINT_LAYOUT_HEAD_SIZE {1024 * 1024}; // head of the log read for timestamp layout detection
+
+/**
+ * Position reached by the last --checkpoint scan of a log file.
+ */
+struct Checkpoint
+{
+    std::string logPath;      // absolute path of the scanned log
+    dev_t device {0};
+    ino_t inode {0};
+    off_t offset {0};         // end of the last complete line scanned
+    int lineNumber {0};       // number of lines before offset
+    uint64_t fingerprint {0}; // hash of the CHECKPOINT_FINGERPRINT_SIZE bytes before offset
+    // Detected from the head of the log (appended tails may start undated); std::nullopt until
+    // detected, UNKNOWN once a complete head was found to have no timestamps
+    std::optional<TimestampLayout> layout;
+};
+
+/**
+ * Reads a checkpoint state file.
+ *
+ * @param statePath State file written by save_checkpoint().
+ * @return The checkpoint, or std::nullopt if the file does not exist yet.
+ * @throws std::runtime_error if the file exists but is malformed.
+ */
+std::optional<Checkpoint> load_checkpoint(const std::string& statePath);
+
+/**
+ * Writes a checkpoint state file atomically (temporary file + rename),
+ * so an interrupted run never leaves a half-written state behind.
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void save_checkpoint(const std::string& statePath, const Checkpoint& checkpoint);
+
+/**
+ * Incremental search for periodic jobs (--checkpoint, --since-last).
+ *
+ * With --since-last only the data appended since the recorded checkpoint is
+ * mapped and scanned, and line numbers continue from the previous run:
+ *   - Same inode and matching fingerprint: the tail after the offset is scanned.
+ *   - Otherwise the log was rotated or truncated: the predecessor (a sibling
+ *     such as <log>.1 with the recorded inode, or a copy whose bytes match the
+ *     fingerprint) is finished first, then the new file is scanned from the start.
+ * A trailing line without newline is left for the next run. The timestamp
+ * layout is only detected when -from/-to or --output jsonl|binary need it,
+ * from the first CHECKPOINT_LAYOUT_HEAD_SIZE bytes of the log, and is kept in
+ * the state file (also when none was found). The state file is updated after
+ * the scan completes.
+ *
+ * @param options Parsed program options (checkpointPath set).
+ * @return EXIT_SUCCESS on completion.
+ * @throws std::runtime_error on file, mapping or state file errors.
+ */
+int search_since_checkpoint(const ProgramOptions& options);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,405 @@
+// src/daemon.cpp
+
+#include "daemon.h"
+#include "file_processor.h"
+#include "pack.h"
+#include "protocol.h"
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <sys/socket.h>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+    /*
+    * Least-recently-used cache of shared values.
+    * Evicted values stay alive while in-flight requests still hold them.
+    * Not synchronized: callers lock around get()/put().
+    */
+    template <typename Key, typename Value>
+    class LruCache
+    {
+    public:
+        explicit LruCache(size_t capacity) : m_capacity {capacity} {}
+
+        std::shared_ptr<Value> get(const Key& key)
+        {
+            auto found {m_index.find(key)};
+            if (found == m_index.end())
+            {
+                return nullptr;
+            }
+            m_items.splice(m_items.begin(), m_items, found->second); // mark as most recent
+            return found->second->second;
+        }
+
+        void put(const Key& key, std::shared_ptr<Value> value)
+        {
+            auto found {m_index.find(key)};
+            if (found != m_index.end())
+            {
+                m_items.erase(found->second);
+                m_index.erase(found);
+            }
+
+            m_items.emplace_front(key, std::move(value));
+            m_index[key] = m_items.begin();
+
+            if (m_items.size() > m_capacity)
+            {
+                m_index.erase(m_items.back().first);
+                m_items.pop_back();
+            }
+        }
+
+    private:
+        using Item = std::pair<Key, std::shared_ptr<Value>>;
+
+        size_t m_capacity;
+        std::list<Item> m_items; // front = most recently used
+        std::unordered_map<Key, typename std::list<Item>::iterator> m_index;
+    };
+
+    // Resident mapping plus what identifies the file version it was made from
+    struct CachedFile
+    {
+        MappedFile file;
+        dev_t device;
+        ino_t inode;
+        off_t size;
+        timespec modified;
+
+        std::once_flag dateOnce;
+        TimestampLayout dateFormat {};
+
+        CachedFile(const std::string& path, const struct stat& sb)
+            : file {path},
+              device {sb.st_dev},
+              inode {sb.st_ino},
+              size {sb.st_size},
+              modified {sb.st_mtim}
+        {
+        }
+
+        bool matches(const struct stat& sb) const
+        {
+            return device == sb.st_dev && inode == sb.st_ino && size == sb.st_size
+                && modified.tv_sec == sb.st_mtim.tv_sec && modified.tv_nsec == sb.st_mtim.tv_nsec;
+        }
+
+        // Detected on first use only, then shared by every query on this mapping
+        TimestampLayout date_format()
+        {
+            std::call_once(dateOnce, [this] { dateFormat = detect_timestamp_layout(file.view()); });
+            return dateFormat;
+        }
+    };
+
+    class QueryServer
+    {
+    public:
+        QueryServer()
+            : m_files {FILE_CACHE_CAPACITY},
+              m_queries {QUERY_CACHE_CAPACITY}
+        {
+        }
+
+        void enqueue(int clientFd)
+        {
+            {
+                std::lock_guard lock {m_queueMutex};
+                m_pending.push_back(clientFd);
+            }
+            m_queueReady.notify_one();
+        }
+
+        void worker_loop()
+        {
+            while (true)
+            {
+                int clientFd {-1};
+                {
+                    std::unique_lock lock {m_queueMutex};
+                    m_queueReady.wait(lock, [this] { return !m_pending.empty(); });
+                    clientFd = m_pending.front();
+                    m_pending.pop_front();
+                }
+
+                handle_connection(clientFd);
+                close(clientFd);
+            }
+        }
+
+    private:
+        std::shared_ptr<CachedFile> acquire_file(const std::string& path)
+        {
+            struct stat sb;
+            if (stat(path.c_str(), &sb) == -1)
+            {
+                throw std::runtime_error("Failed to open file: " + path);
+            }
+
+            {
+                std::lock_guard lock {m_cacheMutex};
+                auto cached {m_files.get(path)};
+                if (cached && cached->matches(sb))
+                {
+                    return cached;
+                }
+            }
+
+            // Map outside the lock so other requests are not blocked
+            auto fresh {std::make_shared<CachedFile>(path, sb)};
+            std::lock_guard lock {m_cacheMutex};
+            m_files.put(path, fresh);
+            return fresh;
+        }
+
+        std::shared_ptr<const LineMatcher> acquire_matcher(const ProgramOptions& options)
+        {
+            // Everything LineMatcher depends on
+            std::string key {options.useRegex ? "r" : "-"};
+            key += options.caseInsensitive ? "i" : "-";
+            key += encode_arguments(options.searchPatterns);
+
+            {
+                std::lock_guard lock {m_cacheMutex};
+                if (auto cached {m_queries.get(key)})
+                {
+                    return cached;
+                }
+            }
+
+            auto compiled {std::make_shared<const LineMatcher>(options)};
+            std::lock_guard lock {m_cacheMutex};
+            m_queries.put(key, compiled);
+            return compiled;
+        }
+
+        void handle_connection(int fd)
+        {
+            int exitCode {EXIT_SUCCESS};
+
+            try
+            {
+                FrameType type;
+                std::string payload;
+                if (!read_frame(fd, type, payload) || type != FrameType::REQUEST)
+                {
+                    return;
+                }
+
+                // Same argument handling as the command line: argv = {program, args...}
+                std::vector<std::string> args {decode_arguments(payload)};
+                args.insert(args.begin(), "logparser");
+                std::vector<char*> argv;
+                for (auto& arg : args)
+                {
+                    argv.push_back(arg.data());
+                }
+
+                ProgramOptions options {parse_arguments(static_cast<int>(argv.size()), argv.data())};
+                if (options.patternsMode || options.estimateMode || !options.queryFilePath.empty()
+                    || !options.outputFilePath.empty() || !options.checkpointPath.empty())
+                {
+                    throw std::runtime_error("--patterns, --query-file, --checkpoint, --estimate and -o are not supported by the daemon.");
+                }
+
+                // Checked before mapping so archives never enter the file cache
+                if (is_pack_file(options.inputFilePath))
+                {
+                    throw std::runtime_error(".lpk archives are not supported by the daemon.");
+                }
+
+                auto cachedFile {acquire_file(options.inputFilePath)};
+
+                auto matcher {acquire_matcher(options)};
+                if (options.fromTime || options.toTime)
+                {
+                    options.detectedDateFormat = cachedFile->date_format();
+                }
+
+                // Matches are streamed back while the scan runs; a vanished client aborts the scan
+                FrameStreamBuf outBuffer(fd, FrameType::STDOUT);
+                FrameStreamBuf errBuffer(fd, FrameType::STDERR);
+                std::ostream out(&outBuffer);
+                std::ostream err(&errBuffer);
+                out.exceptions(std::ios::badbit);
+
+                search_buffer(cachedFile->file.view(), options, *matcher, out, err);
+                err.flush();
+                out.flush();
+            }
+
+            catch (const std::exception& ex)
+            {
+                exitCode = EXIT_FAILURE;
+                try
+                {
+                    write_frame(fd, FrameType::STDERR, std::string("Error: ") + ex.what() + "\n");
+                }
+                catch (const std::exception&)
+                {
+                    return; // client is gone
+                }
+            }
+
+            try
+            {
+                write_frame(fd, FrameType::EXIT, std::string(1, static_cast<char>(exitCode)));
+            }
+            catch (const std::exception&)
+            {
+                // client is gone
+            }
+        }
+
+        std::mutex m_cacheMutex;
+        LruCache<std::string, CachedFile> m_files;
+        LruCache<std::string, const LineMatcher> m_queries;
+
+        std::mutex m_queueMutex;
+        std::condition_variable m_queueReady;
+        std::deque<int> m_pending;
+    };
+}
+
+int run_server(const std::string& socketPath, int threads)
+{
+    int listenFd {listen_unix_socket(socketPath)};
+    size_t workerCount {resolve_thread_count(threads)};
+
+    QueryServer server;
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t t = 0; t < workerCount; ++t)
+    {
+        workers.emplace_back(&QueryServer::worker_loop, &server);
+    }
+
+    std::cout << "Listening on " << socketPath << " (" << workerCount << " workers)" << std::endl;
+
+    while (true)
+    {
+        int clientFd {accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC)};
+        if (clientFd == -1)
+        {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            close(listenFd);
+            throw std::runtime_error("Failed to accept connection: " + std::string(strerror(errno)));
+        }
+        server.enqueue(clientFd);
+    }
+}
+
+int run_client(const std::string& socketPath, const std::vector<std::string>& args)
+{
+    int fd {connect_unix_socket(socketPath)};
+
+    try
+    {
+        write_frame(fd, FrameType::REQUEST, encode_arguments(args));
+
+        FrameType type;
+        std::string payload;
+        while (read_frame(fd, type, payload))
+        {
+            switch (type)
+            {
+                case FrameType::STDOUT:
+                    std::cout.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+                    break;
+                case FrameType::STDERR:
+                    std::cout.flush();
+                    std::cerr.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+                    break;
+                case FrameType::EXIT:
+                    close(fd);
+                    std::cout.flush();
+                    return payload.empty() ? EXIT_FAILURE : static_cast<unsigned char>(payload[0]);
+                default:
+                    break;
+            }
+        }
+    }
+
+    catch (...)
+    {
+        close(fd);
+        throw;
+    }
+
+    close(fd);
+    throw std::runtime_error("Daemon closed the connection unexpectedly.");
+}
+
+int run_daemon_command(int argc, char* argv[])
+{
+    std::string command {argv[1]};
+    std::string socketPath {DEFAULT_SOCKET_PATH};
+    int threads {0};
+    std::vector<std::string> args;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg {argv[i]};
+
+        if (arg == "--socket")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --socket flag.");
+            }
+            socketPath = argv[++i];
+        }
+
+        else if (command == "serve" && arg == "--threads")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --threads flag.");
+            }
+
+            try
+            {
+                threads = std::stoi(argv[++i]);
+            }
+
+            catch (const std::exception&)
+            {
+                throw std::runtime_error("Invalid integer value for --threads flag: " + std::string(argv[i]));
+            }
+        }
+
+        else if (command == "serve")
+        {
+            throw std::runtime_error("Unknown option for serve: " + arg);
+        }
+
+        else
+        {
+            args.push_back(std::move(arg));
+        }
+    }
+
+    if (command == "serve")
+    {
+        return run_server(socketPath, threads);
+    }
+
+    if (args.size() < 2)
+    {
+        throw std::runtime_error("Usage: " + std::string(argv[0]) + " query [--socket <path>] <input_file> <search_pattern1> [search_pattern2 ...] [options]");
+    }
+
+    // The daemon resolves paths from its own working directory
+    args[0] = std::filesystem::absolute(args[0]).string();
+    return run_client(socketPath, args);
+}
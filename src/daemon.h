@@ -0,0 +1,53 @@
+// src/daemon.h
+
+#ifndef DAEMON_H
+#define DAEMON_H
+
+#include <string>
+#include <vector>
+
+constexpr size_t QUERY_CACHE_CAPACITY {128}; // compiled queries kept by the daemon
+constexpr size_t FILE_CACHE_CAPACITY {16};   // mapped files kept by the daemon
+
+/**
+ * Resident query daemon (`logparser serve`).
+ *
+ * Listens on a Unix socket and answers search requests (same arguments as the
+ * normal command line) without paying process startup per query:
+ *   - File mappings stay resident and are reused while inode, size and mtime match;
+ *     the detected timestamp layout is cached with the mapping.
+ *   - Compiled queries (patterns, regexes, required literals) live in an LRU cache.
+ *   - Connections are served by a shared worker pool; matches are streamed back
+ *     in frames while the scan is running (see protocol.h).
+ *
+ * @param socketPath Unix socket path to listen on.
+ * @param threads Worker threads (0 = one per hardware thread).
+ * @return Does not return under normal operation.
+ * @throws std::runtime_error if the socket cannot be created.
+ */
+int run_server(const std::string& socketPath, int threads);
+
+/**
+ * Client for the daemon (`logparser query`): sends the arguments, copies the
+ * streamed output to stdout/stderr and returns the daemon's exit code.
+ *
+ * @param socketPath Unix socket path of the daemon.
+ * @param args Search arguments: <input_file> <patterns...> [options].
+ * @return Exit code reported by the daemon.
+ * @throws std::runtime_error if the daemon cannot be reached.
+ */
+int run_client(const std::string& socketPath, const std::vector<std::string>& args);
+
+/**
+ * Entry point for the `serve` and `query` subcommands.
+ *
+ *   logparser serve [--socket <path>] [--threads <n>]
+ *   logparser query [--socket <path>] <input_file> <pattern1> [pattern2 ...] [options]
+ *
+ * @param argc Argument count from main() (argv[1] is the subcommand).
+ * @param argv Argument vector from main().
+ * @return Process exit code.
+ */
+int run_daemon_command(int argc, char* argv[]);
+
+#endif // DAEMON_H
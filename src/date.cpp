@@ -1,75 +1,490 @@
 // src/date.cpp
 #include "date.h"
+#include <algorithm>
+#include <cctype>
+#include <array>
+#include <limits>
+#include <utility>
+#include <vector>
 
-LogDateFormat detect_date_format(const std::string& dateStr)
+namespace
 {
-    // Regex patterns for different date formats defined in enum LogDateFormat
-    // NOTE: Check YYYY-MM-DD first (most common for logs)
-    static const std::regex ymd(R"(^\d{4}[-./]\d{2}[-./]\d{2})");
+    constexpr int64_t MILLIS_PER_SECOND {1000};
+    constexpr int64_t SECONDS_PER_DAY {86400};
+    constexpr int64_t LOCAL_OFFSET_BUCKET {900};        // seconds; UTC offsets only change at quarter hours
+    constexpr size_t LOCAL_OFFSET_CACHE_SIZE {256};     // cached buckets: more than two days of log time
+    constexpr size_t EPOCH_MILLIS_DIGITS {13};
+    constexpr int64_t EPOCH_MILLIS_MIN {946684800000};  // 2000-01-01, rules out other 13-digit numbers
+    constexpr int64_t EPOCH_MILLIS_MAX {4102444800000}; // 2100-01-01
+    constexpr std::array<std::string_view, 12> MONTH_NAMES {
+        "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+    };
 
-    if (std::regex_search(dateStr, ymd))
-        return LogDateFormat::YYYY_MM_DD_HH_MM_SS;
+    // Broken-down timestamp as read from a line
+    struct CivilTime
+    {
+        int year {0};
+        int month {0};
+        int day {0};
+        int hour {0};
+        int minute {0};
+        int second {0};
+        int millis {0};
+        std::optional<int> utcOffsetSeconds; // std::nullopt = local time
+        size_t end {0};                      // position after the timestamp text
+    };
 
-    // For DD-MM-YYYY vs MM-DD-YYYY
-    // We will default to DD-MM-YYYY (European/ISO standard)
-    // If you need MM-DD-YYYY, change the order or add a config flag
-    static const std::regex dmyOrMdy(R"(^\d{2}[-./]\d{2}[-./]\d{4})");
+    inline bool is_digit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
 
-    if (std::regex_search(dateStr, dmyOrMdy))
+    inline bool is_date_separator(char c)
     {
-        // Try parsing as DD-MM-YYYY first
-        // If your logs are US format, return MM-DD-YYYY instead
-        return LogDateFormat::DD_MM_YYYY_HH_MM_SS;
+        return c == '-' || c == '.' || c == '/';
     }
 
-    return LogDateFormat::UNKNOWN; // Unknown or unsupported format
-}
+    // `count` decimal digits at s[pos]
+    bool read_number(std::string_view s, size_t pos, size_t count, int& value)
+    {
+        if (pos + count > s.size())
+            return false;
 
-std::optional<std::chrono::system_clock::time_point> 
-parse_log_timestamp(std::string_view dateStr, LogDateFormat format)
-{
-    std::tm tm = {};
-    std::string dateString(dateStr);
-    std::istringstream ss(dateString);
-
-    switch (format)
-    {
-        case LogDateFormat::YYYY_MM_DD_HH_MM_SS:
-            ss >> std::get_time(&tm, "%Y-%m-%d %H:%M:%S");
-            break;
-        case LogDateFormat::DD_MM_YYYY_HH_MM_SS:
-            ss >> std::get_time(&tm, "%d-%m-%Y %H:%M:%S");
-            break;
-        case LogDateFormat::MM_DD_YYYY_HH_MM_SS:
-            ss >> std::get_time(&tm, "%m-%d-%Y %H:%M:%S");
-            break;
-        default:
+        int result {0};
+        for (size_t i = pos; i < pos + count; ++i)
+        {
+            if (!is_digit(s[i]))
+                return false;
+            result = result * 10 + (s[i] - '0');
+        }
+        value = result;
+        return true;
+    }
+
+    // English month abbreviation at s[pos] ("Jan" ... "Dec")
+    bool read_month_name(std::string_view s, size_t pos, int& month)
+    {
+        if (pos + 3 > s.size())
+            return false;
+
+        std::string_view name {s.substr(pos, 3)};
+        for (size_t m = 0; m < MONTH_NAMES.size(); ++m)
+        {
+            if (name == MONTH_NAMES[m])
+            {
+                month = static_cast<int>(m) + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // "HH:MM:SS" plus optional fraction at s[pos]; pos ends up after what was read
+    bool read_time_of_day(std::string_view s, size_t& pos, CivilTime& t)
+    {
+        if (pos + 8 > s.size() || !read_number(s, pos, 2, t.hour) || s[pos + 2] != ':'
+            || !read_number(s, pos + 3, 2, t.minute) || s[pos + 5] != ':' || !read_number(s, pos + 6, 2, t.second))
+            return false;
+        pos += 8;
+
+        // Any precision, truncated to milliseconds
+        if (pos + 1 < s.size() && (s[pos] == '.' || s[pos] == ',') && is_digit(s[pos + 1]))
+        {
+            int scale {100};
+            for (++pos; pos < s.size() && is_digit(s[pos]); ++pos)
+            {
+                t.millis += (s[pos] - '0') * scale;
+                scale /= 10;
+            }
+        }
+        return t.hour < 24 && t.minute < 60 && t.second <= 60;
+    }
+
+    // Optional zone at s[pos]: "Z", "+HH:MM", "+HHMM" or "+HH"; pos ends up after what was read
+    void read_utc_offset(std::string_view s, size_t& pos, CivilTime& t)
+    {
+        if (pos >= s.size())
+            return;
+        if (s[pos] == 'Z')
+        {
+            t.utcOffsetSeconds = 0;
+            ++pos;
+            return;
+        }
+
+        int hours {0};
+        int minutes {0};
+        if ((s[pos] != '+' && s[pos] != '-') || !read_number(s, pos + 1, 2, hours))
+            return;
+
+        size_t minutesPos {pos + 3};
+        if (minutesPos < s.size() && s[minutesPos] == ':')
+            ++minutesPos;
+        bool withMinutes {read_number(s, minutesPos, 2, minutes)};
+
+        int offset {hours * 3600 + minutes * 60};
+        t.utcOffsetSeconds = s[pos] == '-' ? -offset : offset;
+        pos = withMinutes ? minutesPos + 2 : pos + 3;
+    }
+
+    // Days since 1970-01-01 of a proleptic Gregorian date (H. Hinnant's days_from_civil)
+    int64_t days_from_civil(int year, int month, int day)
+    {
+        year -= month <= 2;
+        int64_t era {(year >= 0 ? year : year - 399) / 400};
+        int64_t yearOfEra {year - era * 400};
+        int64_t dayOfYear {(153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1};
+        int64_t dayOfEra {yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear};
+        return era * 146097 + dayOfEra - 719468;
+    }
+
+    int days_in_month(int year, int month)
+    {
+        constexpr int DAYS[] {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        bool leapYear {year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)};
+        return month == 2 && leapYear ? 29 : DAYS[month - 1];
+    }
+
+    // UTC offset of local wall-clock time: one mktime() per quarter hour of log time, cached
+    // per thread in a direct-mapped table so logs that are not in time order stay cheap
+    std::optional<int64_t> local_utc_offset(int64_t wallSeconds, const CivilTime& t)
+    {
+        struct CachedOffset
+        {
+            int64_t bucket {std::numeric_limits<int64_t>::min()};
+            int64_t offset {0};
+        };
+        thread_local std::array<CachedOffset, LOCAL_OFFSET_CACHE_SIZE> cache {};
+
+        int64_t bucket {(wallSeconds >= 0 ? wallSeconds : wallSeconds - LOCAL_OFFSET_BUCKET + 1) / LOCAL_OFFSET_BUCKET};
+        CachedOffset& cached {cache[static_cast<uint64_t>(bucket) % LOCAL_OFFSET_CACHE_SIZE]};
+        if (bucket != cached.bucket)
+        {
+            std::tm tm {};
+            tm.tm_year = t.year - 1900;
+            tm.tm_mon = t.month - 1;
+            tm.tm_mday = t.day;
+            tm.tm_hour = t.hour;
+            tm.tm_min = t.minute;
+            tm.tm_sec = t.second;
+            tm.tm_isdst = -1;
+
+            std::time_t local {std::mktime(&tm)};
+            if (local == -1)
+                return std::nullopt;
+
+            cached.offset = wallSeconds - static_cast<int64_t>(local);
+            cached.bucket = bucket;
+        }
+        return cached.offset;
+    }
+
+    std::optional<std::chrono::system_clock::time_point> to_time_point(const CivilTime& t)
+    {
+        if (t.month < 1 || t.month > 12 || t.day < 1 || t.day > days_in_month(t.year, t.month))
             return std::nullopt;
+
+        int64_t seconds {days_from_civil(t.year, t.month, t.day) * SECONDS_PER_DAY + t.hour * 3600 + t.minute * 60 + t.second};
+        if (t.utcOffsetSeconds)
+        {
+            seconds -= *t.utcOffsetSeconds;
+        }
+        else
+        {
+            auto offset {local_utc_offset(seconds, t)};
+            if (!offset)
+                return std::nullopt;
+            seconds -= *offset;
+        }
+        return std::chrono::system_clock::time_point(std::chrono::milliseconds(seconds * MILLIS_PER_SECOND + t.millis));
     }
 
-    if (ss.fail())
-        return std::nullopt;
+    // Syslog timestamps have no year: the latest one that does not put the date after tomorrow
+    int syslog_year(int month, int day)
+    {
+        static const std::tm today {[] {
+            std::time_t now {std::time(nullptr)};
+            std::tm tm {};
+            localtime_r(&now, &tm);
+            return tm;
+        }()};
 
-    std::time_t tt = std::mktime(&tm);
-    if (tt == -1)
-        return std::nullopt;
+        int currentMonth {today.tm_mon + 1};
+        bool ahead {month > currentMonth || (month == currentMonth && day > today.tm_mday + 1)};
+        return today.tm_year + 1900 - ahead;
+    }
+
+    // YYYY-MM-DD HH:MM:SS[.fff][zone] ('T' accepted between date and time, '-', '.' or '/' in the date)
+    bool parse_year_first(std::string_view s, size_t pos, CivilTime& t)
+    {
+        if (pos + 11 > s.size() || !read_number(s, pos, 4, t.year) || !is_date_separator(s[pos + 4])
+            || !read_number(s, pos + 5, 2, t.month) || !is_date_separator(s[pos + 7])
+            || !read_number(s, pos + 8, 2, t.day) || (s[pos + 10] != ' ' && s[pos + 10] != 'T'))
+            return false;
+
+        pos += 11;
+        if (!read_time_of_day(s, pos, t))
+            return false;
+        read_utc_offset(s, pos, t);
+        t.end = pos;
+        return true;
+    }
+
+    // DD-MM-YYYY HH:MM:SS[.fff][zone], or MM-DD-YYYY ...
+    bool parse_year_last(std::string_view s, size_t pos, CivilTime& t, bool monthFirst)
+    {
+        int first {0};
+        int second {0};
+        if (pos + 11 > s.size() || !read_number(s, pos, 2, first) || !is_date_separator(s[pos + 2])
+            || !read_number(s, pos + 3, 2, second) || !is_date_separator(s[pos + 5])
+            || !read_number(s, pos + 6, 4, t.year) || (s[pos + 10] != ' ' && s[pos + 10] != 'T'))
+            return false;
+
+        t.day = monthFirst ? second : first;
+        t.month = monthFirst ? first : second;
+        pos += 11;
+        if (!read_time_of_day(s, pos, t))
+            return false;
+        read_utc_offset(s, pos, t);
+        t.end = pos;
+        return true;
+    }
+
+    // Mmm dd HH:MM:SS[.fff] (day space padded or not)
+    bool parse_syslog(std::string_view s, size_t pos, CivilTime& t)
+    {
+        if (!read_month_name(s, pos, t.month) || pos + 5 > s.size() || s[pos + 3] != ' ')
+            return false;
 
-    return std::chrono::system_clock::from_time_t(tt);
+        pos += 4;
+        if (s[pos] == ' ')
+            ++pos;
+        if (read_number(s, pos, 2, t.day))
+            pos += 2;
+        else if (read_number(s, pos, 1, t.day))
+            pos += 1;
+        else
+            return false;
+
+        if (pos >= s.size() || s[pos] != ' ')
+            return false;
+        ++pos;
+        if (!read_time_of_day(s, pos, t))
+            return false;
+
+        t.year = syslog_year(t.month, t.day);
+        t.end = pos;
+        return true;
+    }
+
+    // [dd/Mmm/yyyy:HH:MM:SS[.fff] +zzzz] with the '[' at s[pos]
+    bool parse_common_log(std::string_view s, size_t pos, CivilTime& t)
+    {
+        if (pos + 21 > s.size() || s[pos] != '[' || !read_number(s, pos + 1, 2, t.day) || s[pos + 3] != '/'
+            || !read_month_name(s, pos + 4, t.month) || s[pos + 7] != '/' || !read_number(s, pos + 8, 4, t.year)
+            || s[pos + 12] != ':')
+            return false;
+
+        pos += 13;
+        if (!read_time_of_day(s, pos, t))
+            return false;
+        if (pos < s.size() && s[pos] == ' ')
+        {
+            size_t zonePos {pos + 1};
+            read_utc_offset(s, zonePos, t);
+            pos = t.utcOffsetSeconds ? zonePos : pos;
+        }
+        t.end = pos < s.size() && s[pos] == ']' ? pos + 1 : pos;
+        return true;
+    }
+
+    // 13 digits (a whole number, not part of a longer one)
+    bool parse_epoch_millis(std::string_view s, size_t pos, int64_t& millis)
+    {
+        if (pos + EPOCH_MILLIS_DIGITS > s.size() || (pos > 0 && is_digit(s[pos - 1]))
+            || (pos + EPOCH_MILLIS_DIGITS < s.size() && is_digit(s[pos + EPOCH_MILLIS_DIGITS])))
+            return false;
+
+        int64_t value {0};
+        for (size_t i = pos; i < pos + EPOCH_MILLIS_DIGITS; ++i)
+        {
+            if (!is_digit(s[i]))
+                return false;
+            value = value * 10 + (s[i] - '0');
+        }
+        millis = value;
+        return value >= EPOCH_MILLIS_MIN && value < EPOCH_MILLIS_MAX;
+    }
+
+    // Specialized parser of each layout, at a known position
+    std::optional<TimestampMatch> parse_at(std::string_view line, LogDateFormat format, size_t pos)
+    {
+        CivilTime t;
+        bool parsed {false};
+
+        switch (format)
+        {
+            case LogDateFormat::YYYY_MM_DD_HH_MM_SS:
+                parsed = parse_year_first(line, pos, t);
+                break;
+            case LogDateFormat::DD_MM_YYYY_HH_MM_SS:
+                parsed = parse_year_last(line, pos, t, false);
+                break;
+            case LogDateFormat::MM_DD_YYYY_HH_MM_SS:
+                parsed = parse_year_last(line, pos, t, true);
+                break;
+            case LogDateFormat::SYSLOG:
+                parsed = parse_syslog(line, pos, t);
+                break;
+            case LogDateFormat::COMMON_LOG:
+                parsed = parse_common_log(line, pos, t);
+                break;
+            case LogDateFormat::EPOCH_MILLIS:
+            {
+                int64_t millis {0};
+                if (!parse_epoch_millis(line, pos, millis))
+                    return std::nullopt;
+                return TimestampMatch {std::chrono::system_clock::time_point(std::chrono::milliseconds(millis)),
+                                       pos, pos + EPOCH_MILLIS_DIGITS, true};
+            }
+            default:
+                return std::nullopt;
+        }
+
+        if (!parsed)
+            return std::nullopt;
+
+        auto timePoint {to_time_point(t)};
+        if (!timePoint)
+            return std::nullopt;
+        return TimestampMatch {*timePoint, pos, t.end, t.utcOffsetSeconds.has_value()};
+    }
+}
+
+std::optional<TimestampLayout> find_timestamp_layout(std::string_view line)
+{
+    // Leftmost timestamp; DD-MM-YYYY is preferred over MM-DD-YYYY (European/ISO standard)
+    constexpr LogDateFormat NUMERIC_FORMATS[] {
+        LogDateFormat::YYYY_MM_DD_HH_MM_SS, LogDateFormat::DD_MM_YYYY_HH_MM_SS, LogDateFormat::EPOCH_MILLIS
+    };
+
+    size_t lastColumn {std::min(line.size(), DATE_DETECTION_MAX_COLUMN)};
+    for (size_t column = 0; column < lastColumn; ++column)
+    {
+        char c {line[column]};
+        if (c == '[' && parse_at(line, LogDateFormat::COMMON_LOG, column))
+        {
+            return TimestampLayout {LogDateFormat::COMMON_LOG, 0};
+        }
+
+        // Timestamps start a word
+        if (column > 0 && std::isalnum(static_cast<unsigned char>(line[column - 1])))
+        {
+            continue;
+        }
+
+        if (is_digit(c))
+        {
+            for (LogDateFormat format : NUMERIC_FORMATS)
+            {
+                if (parse_at(line, format, column))
+                {
+                    return TimestampLayout {format, static_cast<uint16_t>(column)};
+                }
+            }
+        }
+        else if (c >= 'A' && c <= 'Z' && parse_at(line, LogDateFormat::SYSLOG, column))
+        {
+            return TimestampLayout {LogDateFormat::SYSLOG, static_cast<uint16_t>(column)};
+        }
+    }
+    return std::nullopt;
 }
 
+TimestampLayout detect_timestamp_layout(std::string_view data)
+{
+    // Votes per (layout, column): a stray date in a message does not decide the layout
+    std::vector<std::pair<TimestampLayout, size_t>> votes;
+    size_t lineStart {0};
+
+    for (size_t sampled = 0; sampled < DATE_DETECTION_MAX_LINES && lineStart < data.size(); ++sampled)
+    {
+        size_t lineEnd {data.find('\n', lineStart)};
+        lineEnd = lineEnd == std::string_view::npos ? data.size() : lineEnd;
+
+        std::string_view line {data.substr(lineStart, lineEnd - lineStart)};
+        lineStart = lineEnd + 1;
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.remove_suffix(1);
+        }
+
+        auto layout {find_timestamp_layout(line)};
+        if (!layout)
+        {
+            continue;
+        }
+
+        auto vote {std::find_if(votes.begin(), votes.end(), [&](const auto& entry) { return entry.first == *layout; })};
+        if (vote == votes.end())
+        {
+            votes.push_back({*layout, 0});
+            vote = votes.end() - 1;
+        }
+        if (++vote->second >= DATE_DETECTION_VOTES)
+        {
+            return vote->first;
+        }
+    }
+
+    TimestampLayout best;
+    size_t bestVotes {0};
+    for (const auto& [layout, count] : votes)
+    {
+        if (count > bestVotes)
+        {
+            best = layout;
+            bestVotes = count;
+        }
+    }
+    return best;
+}
 
-std::optional<std::chrono::system_clock::time_point> extract_timestamp(const std::string& line, LogDateFormat format)
+std::optional<std::chrono::system_clock::time_point> parse_timestamp(std::string_view text)
 {
-    // Log timestamp length and format check
-    if (line.size() < TIMESTAMP_PREFIX_LENGTH)
-        return std::nullopt; 
-    if (format == LogDateFormat::UNKNOWN)
+    auto layout {find_timestamp_layout(text)};
+    if (!layout || (layout->format != LogDateFormat::COMMON_LOG && layout->column != 0))
+    {
         return std::nullopt;
+    }
+    return extract_timestamp(text, *layout);
+}
 
-    std::string_view prefix(line.data(), TIMESTAMP_PREFIX_LENGTH);
-    
-    // For performance, no more regex detection here - just parse with known format.
+std::optional<TimestampMatch> find_timestamp(std::string_view line, const TimestampLayout& layout)
+{
+    if (layout.format == LogDateFormat::COMMON_LOG)
+    {
+        // Client address etc. come first: the first '[' that starts a timestamp
+        for (size_t pos {line.find('[')}; pos != std::string_view::npos; pos = line.find('[', pos + 1))
+        {
+            if (auto match {parse_at(line, LogDateFormat::COMMON_LOG, pos)})
+            {
+                return match;
+            }
+        }
+        return std::nullopt;
+    }
 
-    return parse_log_timestamp(prefix, format);
+    // For performance, no detection here - just the parser of the known layout at its column
+    return parse_at(line, layout.format, layout.column);
 }
 
+std::optional<std::chrono::system_clock::time_point> extract_timestamp(std::string_view line, const TimestampLayout& layout)
+{
+    auto match {find_timestamp(line, layout)};
+    if (!match)
+    {
+        return std::nullopt;
+    }
+    return match->time;
+}
@@ -3,56 +3,95 @@
 #define DATE_H
 
 #include <string>
+#include <string_view>
 #include <optional>
 #include <chrono>
-#include <sstream>
-#include <iomanip>
-#include <regex>
+#include <cstdint>
 #include <ctime>
-#include <fstream>
 
-enum class LogDateFormat 
+/*
+ * Timestamp layouts. Fractional seconds (any number of digits after '.' or ',')
+ * are read at millisecond resolution. Timestamps without a zone are local time.
+ */
+enum class LogDateFormat
 {
-    YYYY_MM_DD_HH_MM_SS,
-    DD_MM_YYYY_HH_MM_SS,
-    MM_DD_YYYY_HH_MM_SS,
+    YYYY_MM_DD_HH_MM_SS, // 2025-10-21 08:34:42, ISO-8601 2025-10-21T08:34:42.100Z / +02:00
+    DD_MM_YYYY_HH_MM_SS, // 21-10-2025 08:34:42
+    MM_DD_YYYY_HH_MM_SS, // 10-21-2025 08:34:42
+    SYSLOG,              // Oct 21 08:34:42 (no year: the latest one not in the future)
+    COMMON_LOG,          // [21/Oct/2025:08:34:42 +0000] (nginx/Apache, at the first such '[')
+    EPOCH_MILLIS,        // 1761035682100
     UNKNOWN
 };
 
+// Where timestamps are in the lines of a log, and their layout
+struct TimestampLayout
+{
+    LogDateFormat format {LogDateFormat::UNKNOWN};
+    uint16_t column {0}; // byte offset of the timestamp in the line (unused for COMMON_LOG)
+
+    bool known() const { return format != LogDateFormat::UNKNOWN; }
+    bool operator==(const TimestampLayout&) const = default;
+};
+
+// A timestamp located in a log line
+struct TimestampMatch
+{
+    std::chrono::system_clock::time_point time;
+    size_t begin {0}; // [begin, end) of the timestamp text in the line, zone (and brackets) included
+    size_t end {0};
+    bool absolute {false}; // explicit zone or epoch: does not depend on the local time zone or year
+};
+
 // Constant(s)
-constexpr off_t TIMESTAMP_PREFIX_LENGTH {19}; // Length of "YYYY-MM-DD HH:MM:SS"
+constexpr size_t DATE_DETECTION_MAX_LINES {1000}; // lines sampled by detect_timestamp_layout()
+constexpr size_t DATE_DETECTION_VOTES {16};       // agreeing lines that end the sampling early
+constexpr size_t DATE_DETECTION_MAX_COLUMN {64};  // timestamps must start within this many bytes
 
 /**
- * Detects the date format of a given date string.
- * Checks YYYY-MM-DD first (most common in logs), then falls back to DD-MM-YYYY.
- * Returns UNKNOWN if no known format is detected.
- * 
- * @param dateStr The date string to analyze (should be at least 19 chars for full timestamp).
- * @return Detected format enum, or UNKNOWN if not recognized.
+ * Finds the first timestamp of a known layout in a single line.
+ *
+ * @param line Line to analyze.
+ * @return Layout and column of the timestamp, or std::nullopt if none found.
  */
-LogDateFormat detect_date_format(const std::string& dateStr);
+std::optional<TimestampLayout> find_timestamp_layout(std::string_view line);
 
 /**
- * Parse timestamp string into system_clock::time_point.
- * Format must be pre-detected via detect_date_format().
- * 
- * @param dateStr Timestamp string to parse (e.g., "2025-11-09 14:23:45")
- * @param format Pre-detected format of the timestamp.
- * @return Parsed time_point, or std::nullopt if parsing fails.
+ * Detects the timestamp layout of a log from its first lines (at most
+ * DATE_DETECTION_MAX_LINES): the layout and column found in most of them.
+ *
+ * @param data Log contents.
+ * @return Detected layout, or an UNKNOWN one if no sampled line has a timestamp.
+ */
+TimestampLayout detect_timestamp_layout(std::string_view data);
+
+/**
+ * Parses a standalone timestamp (e.g. a -from/-to argument) in any known layout.
+ *
+ * @param text Timestamp string (e.g., "2025-11-09 14:23:45" or "2025-11-09T14:23:45.500Z").
+ * @return Parsed time_point, or std::nullopt if not recognized.
+ */
+std::optional<std::chrono::system_clock::time_point> parse_timestamp(std::string_view text);
+
+/**
+ * Locates and parses the timestamp of a log line with a pre-detected layout.
+ *
+ * @param line Full log line containing the timestamp.
+ * @param layout Pre-detected layout (see detect_timestamp_layout()).
+ * @return Timestamp, its position in the line and whether it is absolute, or
+ *         std::nullopt if the line has no timestamp there or the layout is unknown.
  */
-std::optional<std::chrono::system_clock::time_point> parse_log_timestamp(
-    std::string_view dateStr, 
-    LogDateFormat format);
+std::optional<TimestampMatch> find_timestamp(std::string_view line, const TimestampLayout& layout);
 
 /**
- * Extracts and parses timestamp from a log line.
- * Assumes timestamp is in first 19 characters of the line.
- * Returns std::nullopt if line too short, format unknown, or parsing fails.
- * 
+ * Extracts and parses the timestamp of a log line with a pre-detected layout.
+ * Allocation-free; a specialized parser per layout.
+ *
  * @param line Full log line containing the timestamp.
- * @param format Pre-detected format of the timestamp (must not be UNKNOWN).
- * @return Parsed time_point, or std::nullopt on failure.
+ * @param layout Pre-detected layout (see detect_timestamp_layout()).
+ * @return Parsed time_point (millisecond resolution), or std::nullopt if the
+ *         line has no timestamp there or the layout is unknown.
  */
-std::optional<std::chrono::system_clock::time_point> extract_timestamp(const std::string& line, LogDateFormat format);
+std::optional<std::chrono::system_clock::time_point> extract_timestamp(std::string_view line, const TimestampLayout& layout);
 
-#endif // DATE_H
\ No newline at end of file
+#endif // DATE_H
@@ -0,0 +1,284 @@
+// src/estimate.cpp
+
+#include "estimate.h"
+#include "file_processor.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+
+namespace
+{
+    constexpr uint64_t ESTIMATE_SEED {0x5EED};       // fixed seed: repeated runs give the same estimate
+    constexpr size_t DATE_DETECTION_MAX_BLOCKS {8};  // blocks tried for timestamp layout detection
+    constexpr double BYTES_PER_MB {1024.0 * 1024.0};
+    constexpr double POISSON_BOUND_MAX_MATCHES {30}; // below this, the normal interval is unreliable
+
+    struct BlockSample
+    {
+        double bytes {0};
+        double matches {0};
+        double lines {0};
+    };
+
+    /*
+    * Lines that start inside [blockStart, blockEnd). Blocks that tile the file
+    * therefore partition its lines, which makes a full-coverage sample exact.
+    */
+    std::string_view block_lines(std::string_view data, size_t blockStart, size_t blockEnd)
+    {
+        size_t first {blockStart};
+        if (first > 0)
+        {
+            const void* newline {memchr(data.data() + first - 1, '\n', data.size() - (first - 1))};
+            if (newline == nullptr)
+            {
+                return {};
+            }
+            first = static_cast<size_t>(static_cast<const char*>(newline) - data.data()) + 1;
+        }
+
+        if (first >= blockEnd)
+        {
+            return {}; // a single long line spans the whole block
+        }
+
+        // The last line starting before blockEnd ends at the first newline from blockEnd - 1
+        const void* newline {memchr(data.data() + blockEnd - 1, '\n', data.size() - (blockEnd - 1))};
+        size_t last {newline ? static_cast<size_t>(static_cast<const char*>(newline) - data.data()) + 1 : data.size()};
+        return data.substr(first, last - first);
+    }
+
+    /*
+    * Start (epoch seconds) of the local-time hour containing a timestamp, so
+    * zones with a non-whole-hour offset bucket on their own hour boundaries.
+    * The last hour is cached: matches of a block mostly fall in the same one.
+    */
+    class LocalHourBuckets
+    {
+    public:
+        int64_t hour_start(std::chrono::system_clock::time_point timestamp)
+        {
+            int64_t seconds {std::chrono::floor<std::chrono::seconds>(timestamp).time_since_epoch().count()};
+            if (seconds < m_cachedStart || seconds >= m_cachedStart + 3600)
+            {
+                std::time_t time {static_cast<std::time_t>(seconds)};
+                std::tm tm {};
+                localtime_r(&time, &tm);
+                m_cachedStart = seconds - tm.tm_min * 60 - tm.tm_sec;
+            }
+            return m_cachedStart;
+        }
+
+    private:
+        int64_t m_cachedStart {std::numeric_limits<int64_t>::min() / 2};
+    };
+
+    std::string hour_label(int64_t hourStart)
+    {
+        std::time_t seconds {static_cast<std::time_t>(hourStart)};
+        std::tm tm {};
+        localtime_r(&seconds, &tm);
+
+        char label[32];
+        std::strftime(label, sizeof(label), "%Y-%m-%d %H:00", &tm);
+        return label;
+    }
+}
+
+int estimate_matches(const ProgramOptions& options)
+{
+    auto started {std::chrono::steady_clock::now()};
+    auto deadline {started + std::chrono::milliseconds(options.estimateBudgetMs)};
+
+    // Random access hint: only the sampled pages are read from disk
+    MappedFile file(options.inputFilePath, 0, AccessPattern::RANDOM);
+    std::string_view data {file.view()};
+    LineMatcher matcher(options);
+
+    bool dateFilter {options.fromTime.has_value() || options.toTime.has_value()};
+    size_t fileSize {data.size()};
+
+    // One block per stratum; with a budget covering the file, blocks tile it completely
+    size_t blocksInFile {(fileSize + ESTIMATE_BLOCK_SIZE - 1) / ESTIMATE_BLOCK_SIZE};
+    size_t budgetBlocks {static_cast<size_t>(options.estimateBudgetMb) * 1024 * 1024 / ESTIMATE_BLOCK_SIZE};
+    size_t strata {std::max<size_t>(1, std::min(blocksInFile, budgetBlocks))};
+
+    // Random stratum order: stopping at the time budget still leaves a uniform sample
+    std::vector<size_t> order(strata);
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937_64 random {ESTIMATE_SEED};
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<BlockSample> samples;
+    samples.reserve(strata);
+
+    double sampledMatches {0};
+    std::array<double, static_cast<size_t>(LogLevel::UNKNOWN) + 1> levelCounts {};
+    std::map<int64_t, double> hourCounts;
+    LocalHourBuckets hourBuckets;
+    TimestampLayout dateFormat {options.detectedDateFormat};
+
+    for (size_t stratum : order)
+    {
+        if (!samples.empty() && std::chrono::steady_clock::now() >= deadline)
+        {
+            break;
+        }
+
+        size_t stratumStart {fileSize * stratum / strata};
+        size_t stratumEnd {fileSize * (stratum + 1) / strata};
+        size_t blockStart {stratumStart};
+        size_t blockEnd {stratumEnd};
+        if (stratumEnd - stratumStart > ESTIMATE_BLOCK_SIZE)
+        {
+            std::uniform_int_distribution<size_t> position(stratumStart, stratumEnd - ESTIMATE_BLOCK_SIZE);
+            blockStart = position(random);
+            blockEnd = blockStart + ESTIMATE_BLOCK_SIZE;
+        }
+
+        std::string_view lines {block_lines(data, blockStart, blockEnd)};
+        if (!dateFormat.known() && samples.size() < DATE_DETECTION_MAX_BLOCKS)
+        {
+            dateFormat = detect_timestamp_layout(lines);
+        }
+
+        BlockSample sample;
+        sample.bytes = static_cast<double>(blockEnd - blockStart);
+
+        const char* lineStart {lines.data()};
+        const char* blockLinesEnd {lines.data() + lines.size()};
+        while (lineStart < blockLinesEnd)
+        {
+            const char* lineEnd {static_cast<const char*>(memchr(lineStart, '\n', blockLinesEnd - lineStart))};
+            lineEnd = lineEnd ? lineEnd : blockLinesEnd;
+
+            off_t lineLength {lineEnd - lineStart};
+            if (lineLength > 0 && lineStart[lineLength - 1] == '\r')
+            {
+                --lineLength;
+            }
+            std::string_view lineView(lineStart, lineLength);
+            lineStart = lineEnd + 1;
+            ++sample.lines;
+
+            if (!matcher.matches(lineView))
+            {
+                continue;
+            }
+
+            LogLevel level {detect_log_level(lineView, options.logFormat)};
+            if (!level_in_mask(level, options.levelMask))
+            {
+                continue;
+            }
+
+            auto ts {extract_timestamp(lineView, dateFormat)};
+            if (dateFilter && ts && ((options.fromTime && *ts < *options.fromTime) || (options.toTime && *ts > *options.toTime)))
+            {
+                continue;
+            }
+
+            ++sample.matches;
+            ++levelCounts[static_cast<size_t>(level)];
+            if (ts)
+            {
+                hourCounts[hourBuckets.hour_start(*ts)] += 1;
+            }
+        }
+
+        sampledMatches += sample.matches;
+        samples.push_back(sample);
+    }
+
+    // Ratio estimator (matches per byte) x file size, with finite population correction
+    double sampledBytes {0};
+    double sampledLines {0};
+    for (const auto& sample : samples)
+    {
+        sampledBytes += sample.bytes;
+        sampledLines += sample.lines;
+    }
+
+    double n {static_cast<double>(samples.size())};
+    double total {static_cast<double>(fileSize)};
+    double ratio {sampledBytes > 0 ? sampledMatches / sampledBytes : 0.0};
+    double estimatedMatches {ratio * total};
+    double estimatedLines {sampledBytes > 0 ? sampledLines / sampledBytes * total : 0.0};
+    double coverage {total > 0 ? std::min(1.0, sampledBytes / total) : 1.0};
+
+    double halfWidth {0};
+    if (n > 1 && coverage < 1.0)
+    {
+        double residuals {0};
+        for (const auto& sample : samples)
+        {
+            double residual {sample.matches - ratio * sample.bytes};
+            residuals += residual * residual;
+        }
+        double meanBytes {sampledBytes / n};
+        double ratioVariance {(1.0 - coverage) * residuals / ((n - 1) * n * meanBytes * meanBytes)};
+        halfWidth = CONFIDENCE_Z * total * std::sqrt(ratioVariance);
+    }
+
+    // With few sampled matches the normal interval degenerates (0 - 0 when none
+    // matched): bound it by a Poisson upper limit, k + 3 + z*sqrt(k) matches in the
+    // sampled bytes, which is the rule of three for k = 0
+    double upperMatches {estimatedMatches + halfWidth};
+    if (sampledBytes > 0 && sampledMatches < POISSON_BOUND_MAX_MATCHES)
+    {
+        double poissonUpper {sampledMatches + 3.0 + CONFIDENCE_Z * std::sqrt(sampledMatches)};
+        upperMatches = std::max(upperMatches, poissonUpper / sampledBytes * total);
+    }
+
+    auto elapsed {std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started)};
+
+    std::cout << "Sampled: " << samples.size() << " of " << strata << " blocks, "
+              << std::fixed << std::setprecision(1) << sampledBytes / BYTES_PER_MB << " MB of "
+              << total / BYTES_PER_MB << " MB (" << 100.0 * coverage << "%) in " << elapsed.count() << " ms\n";
+
+    std::cout << std::setprecision(0);
+    if (coverage >= 1.0)
+    {
+        std::cout << "Estimated Matches: " << estimatedMatches << " (exact: whole file sampled)\n";
+    }
+    else
+    {
+        std::cout << "Estimated Matches: " << estimatedMatches << " (95% CI: "
+                  << std::max(sampledMatches, estimatedMatches - halfWidth) << " - " << upperMatches << ")\n";
+    }
+    std::cout << "Estimated Lines: " << estimatedLines << '\n';
+
+    if (sampledMatches > 0)
+    {
+        std::cout << "\nLevels (share of sampled matches):\n" << std::setprecision(2);
+        for (size_t level = 0; level < levelCounts.size(); ++level)
+        {
+            if (levelCounts[level] > 0)
+            {
+                LogLevel logLevel {static_cast<LogLevel>(level)};
+                std::cout << get_log_level_color(logLevel) << "  " << get_log_level_name(logLevel) << ": "
+                          << 100.0 * levelCounts[level] / sampledMatches << "%" << RESET_COLOR << '\n';
+            }
+        }
+    }
+
+    if (!hourCounts.empty())
+    {
+        // Sampled counts scaled to the estimated total
+        double scale {estimatedMatches / sampledMatches};
+        std::cout << "\nPer Hour (estimated matches):\n" << std::setprecision(0);
+        for (const auto& [hour, count] : hourCounts)
+        {
+            std::cout << "  " << hour_label(hour) << "  " << count * scale << '\n';
+        }
+    }
+
+    std::cout << std::flush;
+    return EXIT_SUCCESS;
+}
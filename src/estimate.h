@@ -0,0 +1,32 @@
+// src/estimate.h
+
+#ifndef ESTIMATE_H
+#define ESTIMATE_H
+
+#include "arg_parser.h"
+
+constexpr size_t ESTIMATE_BLOCK_SIZE {64 * 1024}; // bytes per sampled block
+constexpr double CONFIDENCE_Z {1.96};             // 95% confidence interval
+
+/**
+ * --estimate mode: estimates the match count of a query from random samples
+ * instead of scanning the whole file.
+ *
+ * The file is divided into equal strata by position (logs are written in time
+ * order, so position stands in for time) and one random newline-aligned block
+ * is read from each stratum, in random order, until the time (--budget-ms) or
+ * byte (--budget-mb) budget is used up. Each block is scanned with the normal
+ * matcher, level filter and date range filter. The results are:
+ *   - estimated total matches (ratio estimator matches/byte x file size) with a
+ *     95% confidence interval; exact when the budget covers the whole file,
+ *   - per-level proportions of the sampled matches,
+ *   - a coarse per-hour (local time) distribution of the estimated matches.
+ * The mapping is opened with a random-access hint so only sampled pages are read.
+ *
+ * @param options Parsed program options.
+ * @return EXIT_SUCCESS on completion.
+ * @throws std::runtime_error on file or memory mapping errors.
+ */
+int estimate_matches(const ProgramOptions& options);
+
+#endif // ESTIMATE_H
@@ -2,263 +2,361 @@
 
 #include "file_processor.h"
 
-int search_in_file(const ProgramOptions& options)
+namespace
 {
-    /*
-    * CONTEXT LINES ALGORITHM 
-    * 
-    * This function implements grep-style context lines (-A, -B, -C flags).
-    * 
-    * 1. Ring Buffer (Before-Context):
-    *   - Continously stores the last N lines in a deque (instead of vector for faster operations)
-    *   - When match found -> dump buffer, then clear it
-    *   - Deque has O(1) for push_back/pop_front 
-    * 
-    * 2. Countdown Timer (After-Context):
-    *   - After a match, print next N lines regardless of pattern
-    *   - Decrements counter each line until it reaches zero
-    * 
-    * 3. Deduplication:
-    *   - Tracks last printed line number to avoid duplicates
-    *   - Handles overlapping contexts when matches are close together
-    * 
-    * 4. Separators:
-    *   - Prints "--" between close match groups (just like grep)
-    * 
-    * Ex:
-    *   ./logparser log.txt "ERROR" -B 2 -A 1
-    * 
-    *   Output:
-    *   [C:L18] line before match     ← before context (dim)
-    *   [C:L19] line before match     ← before context (dim)
-    *   [0:L20] ERROR: actual match   ← match (colored)
-    *   [C:L21] line after match      ← after context (dim)
-    *   --
-    *   [C:L45] line before match     ← next match group
-    *   [1:L46] ERROR: another match
-    */
-
-    // Open file 
-    int fd = open(options.inputFilePath.c_str(), O_RDONLY);
-    if (fd == -1)
+    // Per-search state shared by both scan strategies
+    struct LineScan
     {
-        throw std::runtime_error("Failed to open file: " + options.inputFilePath);
-    }
-
-    // Get file size
-    struct stat sb;
-    if (fstat(fd, &sb) == -1)
+        const ProgramOptions& options;
+        const LineMatcher& matcher;
+        MatchWriter& writer;
+        bool dateFilter {options.fromTime.has_value() || options.toTime.has_value()};
+        TimestampLayout dateFormat {};
+        int linesWithTimestamps {0};
+    };
+
+    std::string_view trim_line(const char* lineStart, const char* lineEnd)
     {
-        close(fd);
-        throw std::runtime_error("Failed to get file size");
-    }
-    off_t fileSize {sb.st_size};
+        off_t lineLength {lineEnd - lineStart};
 
-    // Empty file check
-    if (fileSize == 0)
-    {
-        close(fd);
-        std::cout << '\n' << "Total matches: 0" << std::endl;
-        return EXIT_SUCCESS;
+        // \r trimming
+        if (lineLength > 0 && lineStart[lineLength - 1] == '\r')
+        {
+            --lineLength;
+        }
+        return std::string_view(lineStart, lineLength);
     }
 
-    // Memory mapping process
-    // MAP_PRIVATE = Changes won't affect the integrity of file
-    // MAP_POPULATE = Prefetch pages into memory (for better performance)
-    char* fileData {static_cast<char*>(mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0))};
-    if (fileData == MAP_FAILED)
+    // Date filtering (stack-only timestamp parsing), true = line is outside the range
+    template <bool DateFilter>
+    bool outside_date_range(LineScan& scan, std::string_view lineView)
     {
-        close(fd);
-        throw std::runtime_error("Memory mapping failed");
+        if constexpr (!DateFilter)
+        {
+            return false;
+        }
+        else
+        {
+            auto ts = extract_timestamp(lineView, scan.dateFormat);
+            if (!ts)
+            {
+                return false; // lines without timestamps (stack traces etc.) are kept
+            }
+
+            ++scan.linesWithTimestamps;
+            return (scan.options.fromTime && *ts < *(scan.options.fromTime))
+                || (scan.options.toTime && *ts > *(scan.options.toTime));
+        }
     }
-    madvise(fileData, fileSize, MADV_SEQUENTIAL | MADV_WILLNEED); // Tell OS to read sequentially
-    close(fd);
 
-    // Compile regex patterns if needed
-    std::vector<std::regex> regexPatterns;
-    if (options.useRegex)
+    // Pattern + level check, then hand the line to the writer (match or context)
+    template <MatchKind Kind, bool CaseFold, bool Context>
+    void handle_line(LineScan& scan, int lineNumber, std::string_view lineView)
     {
-        regexPatterns.reserve(options.searchPatterns.size());
+        bool found {scan.matcher.matches_as<Kind, CaseFold>(lineView)};
+        LogLevel level {LogLevel::UNKNOWN};
+
+        // Level filter (--level) only needs the level of matching lines
+        if (found)
+        {
+            level = detect_log_level(lineView, scan.options.logFormat);
+            found = level_in_mask(level, scan.options.levelMask);
+        }
 
-        for (const auto& pattern : options.searchPatterns)
+        if (found)
+        {
+            scan.writer.write_match(lineNumber, lineView, level);
+        }
+        else if constexpr (Context)
         {
-            regexPatterns.emplace_back(pattern, options.caseInsensitive ? std::regex::icase : std::regex::ECMAScript);
+            if (scan.writer.wants_other_lines())
+            {
+                scan.writer.write_other(lineNumber, lineView);
+            }
         }
     }
 
-    // Context lines implementation
-    // Ring buffer for before-context lines (-B flag)
-    std::deque<std::pair<int, std::string>> beforeBuffer;
+    // Line-by-line strategy: every line is materialized (needed for context lines)
+    template <MatchKind Kind, bool CaseFold, bool DateFilter, bool Context>
+    void search_lines(LineScan& scan, std::string_view data, int firstLineNumber)
+    {
+        int lineNumber {firstLineNumber - 1};
 
-    int afterContextRemaining {0}; // Countdown timer for after-context lines (-A flag)
+        // Line parser with memchr
+        const char* lineStart {data.data()};
+        const char* fileEnd {data.data() + data.size()};
 
-    int lastPrintedLine {-1}; // Deduplication tracker that prevents printing the same line twice
+        while (lineStart < fileEnd)
+        {
+            // Find new line
+            const char* lineEnd {static_cast<const char*>(memchr(lineStart, '\n', fileEnd - lineStart))};
 
-    bool needsSeparator {false}; // Separator flag 
+            if (lineEnd == nullptr)
+            {
+                lineEnd = fileEnd;
+            }
 
-    std::string line;
-    int matchCount {0};
-    int lineNumber {0};
-    int linesWithTimestamps {0};
-    LogDateFormat dateFormat {LogDateFormat::UNKNOWN};
+            std::string_view lineView {trim_line(lineStart, lineEnd)};
+            ++lineNumber;
 
-    constexpr const char* CONTEXT_COLOR = "\033[2m"; // dim 
+            if (!outside_date_range<DateFilter>(scan, lineView))
+            {
+                handle_line<Kind, CaseFold, Context>(scan, lineNumber, lineView);
+            }
 
-    // Line parser with memchr
-    const char* lineStart {fileData};
-    const char* fileEnd {fileData + fileSize};
+            // Move to next line
+            lineStart = lineEnd + (lineEnd < fileEnd ? 1 : 0);
+        }
+    }
 
-    while (lineStart < fileEnd)
+    /*
+    * Buffer-level strategy: the candidate finder runs over the whole mapping and
+    * lines are only discovered around hits. Line numbers come from counting the
+    * newlines in the gap between consecutive hits (SIMD), so lines without a
+    * candidate are never materialized. Only used without context lines.
+    */
+    template <MatchKind Kind, bool CaseFold, bool DateFilter>
+    void search_candidates(LineScan& scan, CandidateFinder& finder, std::string_view data, int firstLineNumber)
     {
-        // Find new line
-        const char* lineEnd {static_cast<const char*>(memchr(lineStart, '\n', fileEnd - lineStart))};
+        const char* fileStart {data.data()};
+        const char* fileEnd {data.data() + data.size()};
 
-        if (lineEnd == nullptr)
-        {
-            lineEnd = fileEnd;
-        }
-
-        off_t lineLength {lineEnd - lineStart};
+        const char* cursor {fileStart};  // next unsearched byte (always a line start)
+        const char* counted {fileStart}; // newlines before this point are in lineNumber
+        int lineNumber {firstLineNumber};
 
-        // \r trimming
-        if (lineLength > 0 && lineStart[lineLength - 1] == '\r')
+        while (cursor < fileEnd)
         {
-            --lineLength;
-        }
+            const char* hit {finder.find(cursor, fileEnd)};
+            if (hit == nullptr)
+            {
+                break;
+            }
 
-        std::string_view lineView(lineStart, lineLength);
-        ++lineNumber;
-        
-        // Detect format without double file open
-        if (dateFormat == LogDateFormat::UNKNOWN && lineView.size() >= TIMESTAMP_PREFIX_LENGTH)
-        {
-            dateFormat = detect_date_format(std::string(lineView.substr(0, TIMESTAMP_PREFIX_LENGTH)));
-        }
+            // Enclosing line boundaries (lines before cursor are already done)
+            const char* lineStart {static_cast<const char*>(memrchr(cursor, '\n', hit - cursor))};
+            lineStart = lineStart ? lineStart + 1 : cursor;
+            const char* lineEnd {static_cast<const char*>(memchr(hit, '\n', fileEnd - hit))};
+            lineEnd = lineEnd ? lineEnd : fileEnd;
 
-        // Date filtering (only create string if we need timestamp)
-        bool skipLine = false;
-        if (options.fromTime || options.toTime)
-        {
-            if (lineLength >= TIMESTAMP_PREFIX_LENGTH)
+            lineNumber += static_cast<int>(count_newlines(counted, lineStart));
+            counted = lineStart;
+
+            std::string_view lineView {trim_line(lineStart, lineEnd)};
+            if (!outside_date_range<DateFilter>(scan, lineView))
             {
-                // Stack buffer to avoid heap allocations
-                char tsBuf[TIMESTAMP_PREFIX_LENGTH + 1];
-                memcpy(tsBuf, lineStart, TIMESTAMP_PREFIX_LENGTH);
-                tsBuf[TIMESTAMP_PREFIX_LENGTH] = '\0';
-                
-                auto ts = parse_log_timestamp(tsBuf, dateFormat);
-                if (ts)
-                {
-                    ++linesWithTimestamps;
-                    if (options.fromTime && *ts < *(options.fromTime))
-                        skipLine = true;
-                    else if (options.toTime && *ts > *(options.toTime))
-                        skipLine = true;
-                }
+                handle_line<Kind, CaseFold, false>(scan, lineNumber, lineView);
             }
+
+            cursor = lineEnd + 1;
         }
+    }
+
+    // Turns a runtime flag into std::true_type / std::false_type for template dispatch
+    template <typename F>
+    void with_flag(bool flag, F&& f)
+    {
+        if (flag)
+            f(std::true_type {});
+        else
+            f(std::false_type {});
+    }
 
-        if (!skipLine)
+    /*
+    * Single runtime dispatch to the scan loop specialized for this option combination
+    * (matcher kind x case folding x date filter x context lines), so the per-line
+    * code has no dead branches for disabled features.
+    */
+    void run_specialized_search(LineScan& scan, std::optional<CandidateFinder>& finder, const LogSegment& segment)
+    {
+        std::string_view data {segment.data};
+        int firstLineNumber {segment.firstLineNumber};
+        bool regex {scan.matcher.kind() == MatchKind::REGEX};
+        bool caseFold {!regex && scan.matcher.case_insensitive()}; // -i is compiled into the regex
+        bool context {scan.options.beforeContext > 0 || scan.options.afterContext > 0};
+
+        // Timestamp layout detected once before the hot loop (or reused from a cache)
+        if (scan.dateFilter || scan.writer.structured())
         {
-            bool found = false;
+            scan.dateFormat = scan.options.detectedDateFormat.known()
+                ? scan.options.detectedDateFormat
+                : detect_timestamp_layout(data);
+        }
 
-            if (options.useRegex)
+        // Lines skipped by the buffer-level search are never parsed; a detected layout proves dated lines exist
+        if (scan.dateFilter)
+        {
+            scan.linesWithTimestamps += scan.dateFormat.known();
+        }
+        scan.writer.set_source(data, segment.fileOffset, scan.dateFormat);
+
+        with_flag(regex, [&](auto regexTag) {
+        with_flag(caseFold, [&](auto caseFoldTag) {
+        with_flag(scan.dateFilter, [&](auto dateTag) {
+        with_flag(context, [&](auto contextTag) {
+            constexpr MatchKind KIND {decltype(regexTag)::value ? MatchKind::REGEX : MatchKind::LITERAL};
+            constexpr bool CASE_FOLD {decltype(caseFoldTag)::value && KIND == MatchKind::LITERAL};
+            constexpr bool DATE_FILTER {decltype(dateTag)::value};
+            constexpr bool CONTEXT {decltype(contextTag)::value};
+
+            // Buffer-level search when lines only matter around hits (no context lines)
+            if (!CONTEXT && finder)
             {
-                // Regex needs string (unavoidable copy)
-                std::string lineStr(lineView);
-                for (const auto& regexPattern : regexPatterns)
-                {
-                    if (std::regex_search(lineStr, regexPattern))
-                    {
-                        found = true;
-                        break;
-                    }
-                }
+                search_candidates<KIND, CASE_FOLD, DATE_FILTER>(scan, *finder, data, firstLineNumber);
             }
             else
             {
-                // Pure string_view matching - NO allocations!
-                for (const auto& pattern : options.searchPatterns)
-                {
-                    bool match = options.caseInsensitive 
-                        ? contains_case_insensitive(lineView, pattern) 
-                        : lineView.find(pattern) != std::string_view::npos;
-
-                    if (match)
-                    {
-                        found = true;
-                        break;
-                    }
-                }
+                search_lines<KIND, CASE_FOLD, DATE_FILTER, CONTEXT>(scan, data, firstLineNumber);
             }
+        });
+        });
+        });
+        });
+    }
+}
 
-            // Context handling
-            if (found)
-            {
-                if (needsSeparator && lastPrintedLine != -1 && lineNumber - lastPrintedLine > 1)
-                {
-                    std::cout << "--\n";
-                }
-
-                for (const auto& [bufLineNum, bufLine] : beforeBuffer)
-                {
-                    if (bufLineNum > lastPrintedLine)
-                    {
-                        std::cout << CONTEXT_COLOR << "[C:L" << bufLineNum << "] " << bufLine << RESET_COLOR << '\n';
-                        lastPrintedLine = bufLineNum;
-                    }
-                }
-
-                LogLevel level = detect_log_level(std::string(lineView), options.logFormat);
-                auto color = get_log_level_color(level);
-                std::cout << color << "[" << static_cast<int>(level) << ":L" << lineNumber << "] " << lineView << RESET_COLOR << '\n';
-                lastPrintedLine = lineNumber;
-                ++matchCount;
-
-                afterContextRemaining = options.afterContext;
-                beforeBuffer.clear();
-                needsSeparator = true;
-            }
+int search_buffer(std::string_view data, const ProgramOptions& options, const LineMatcher& matcher,
+                  std::ostream& out, std::ostream& err)
+{
+    return search_segments({LogSegment {data, 1}}, options, matcher, out, err);
+}
 
-            else if (afterContextRemaining > 0)
-            {
-                if (lineNumber > lastPrintedLine)
-                {
-                    std::cout << CONTEXT_COLOR << "[C:L" << lineNumber << "] " << lineView << RESET_COLOR << '\n';
-                    lastPrintedLine = lineNumber;
-                }
-                --afterContextRemaining;
-            }
+int search_segments(const std::vector<LogSegment>& segments, const ProgramOptions& options,
+                    const LineMatcher& matcher, std::ostream& out, std::ostream& err)
+{
+    size_t next {0};
+    return search_segments([&]() { return next < segments.size() ? &segments[next++] : nullptr; },
+                           options, matcher, out, err);
+}
 
-            else
-            {
-                if (options.beforeContext > 0)
-                {
-                    beforeBuffer.push_back({lineNumber, std::string(lineView)});
-                    if (static_cast<int>(beforeBuffer.size()) > options.beforeContext)
-                    {
-                        beforeBuffer.pop_front();
-                    }
-                }
-            }
+int search_segments(const SegmentSource& nextSegment, const ProgramOptions& options,
+                    const LineMatcher& matcher, std::ostream& out, std::ostream& err)
+{
+    // Context lines implementation (ring buffer, countdown, dedup, separators)
+    MatchWriter writer(out, options.beforeContext, options.afterContext, options.outputFormat, matcher);
+    LineScan scan {options, matcher, writer};
+
+    // A known layout (cached detection) proves dated lines exist even if no segment is scanned
+    scan.linesWithTimestamps += scan.dateFilter && options.detectedDateFormat.known();
+
+    bool first {true};
+    bool anyLines {false};
+    while (const LogSegment* segment {nextSegment()})
+    {
+        anyLines |= !segment->data.empty();
+        if (!first && !segment->continuation)
+        {
+            writer.begin_file();
         }
+        first = false;
 
-        // Move to next line
-        lineStart = lineEnd + (lineEnd < fileEnd ? 1 : 0);
+        // Fresh finder per segment: it caches hit positions inside the previous buffer
+        auto finder {CandidateFinder::create(matcher)};
+        run_specialized_search(scan, finder, *segment);
+    }
+    writer.finish();
+
+    // Warn user if date filtering was applied but no timestamps were found (nothing to scan is not suspicious)
+    if (scan.dateFilter && anyLines && scan.linesWithTimestamps == 0)
+    {
+        err << '\n';
+        err << "Warning: Date filtering was requested, but no valid timestamps were found in the log lines." << std::endl;
     }
 
-    // Cleanup of mapped memory
-    munmap(fileData, fileSize);
+    // Structured output stays machine-readable: records only
+    if (writer.structured())
+    {
+        out.flush();
+        return writer.match_count();
+    }
+
+    out << '\n';
+    out << "Total Matches: " << writer.match_count() << std::endl;
+
+    return writer.match_count();
+}
+
+std::ostream& open_output(const std::string& path, std::ofstream& file)
+{
+    if (path.empty())
+    {
+        return std::cout;
+    }
 
-    // Warn user if date filtering was applied but no timestamps were found
-    if ((options.fromTime || options.toTime) && linesWithTimestamps == 0)
+    file.open(path, std::ios::out | std::ios::trunc);
+    if (!file)
     {
-        std::cerr << '\n';
-        std::cerr << "Warning: Date filtering was requested, but no valid timestamps were found in the log lines." << std::endl;
+        throw std::runtime_error("Failed to open output file: " + path);
     }
+    return file;
+}
+
+int search_in_file(const ProgramOptions& options)
+{
+    /*
+    * CONTEXT LINES ALGORITHM 
+    * 
+    * This function implements grep-style context lines (-A, -B, -C flags).
+    * 
+    * 1. Ring Buffer (Before-Context):
+    *   - Continously stores the last N lines in a deque (instead of vector for faster operations)
+    *   - When match found -> dump buffer, then clear it
+    *   - Deque has O(1) for push_back/pop_front 
+    * 
+    * 2. Countdown Timer (After-Context):
+    *   - After a match, print next N lines regardless of pattern
+    *   - Decrements counter each line until it reaches zero
+    * 
+    * 3. Deduplication:
+    *   - Tracks last printed line number to avoid duplicates
+    *   - Handles overlapping contexts when matches are close together
+    * 
+    * 4. Separators:
+    *   - Prints "--" between close match groups (just like grep)
+    * 
+    * Ex:
+    *   ./logparser log.txt "ERROR" -B 2 -A 1
+    * 
+    *   Output:
+    *   [C:L18] line before match     ← before context (dim)
+    *   [C:L19] line before match     ← before context (dim)
+    *   [0:L20] ERROR: actual match   ← match (colored)
+    *   [C:L21] line after match      ← after context (dim)
+    *   --
+    *   [C:L45] line before match     ← next match group
+    *   [1:L46] ERROR: another match
+    */
+
+    // Memory mapping process (see MappedFile)
+    MappedFile file(options.inputFilePath);
+    off_t fileSize {file.size()};
+
+    // Match destination (-o flag), stdout by default
+    std::ofstream outputFile;
+    std::ostream& out {open_output(options.outputFilePath, outputFile)};
+
+    // Empty file check
+    if (fileSize == 0)
+    {
+        if (options.outputFormat == OutputFormat::TEXT)
+        {
+            out << '\n' << "Total matches: 0" << std::endl;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Timestamp layout detected once from the first lines (date filter and --output records)
+    ProgramOptions scanOptions {options};
+    if (!scanOptions.detectedDateFormat.known()
+        && (options.fromTime || options.toTime || options.outputFormat != OutputFormat::TEXT))
+    {
+        scanOptions.detectedDateFormat = detect_timestamp_layout(file.view());
+    }
+
+    // Compile search patterns (regex if -r flag is set)
+    LineMatcher matcher(scanOptions);
 
-    std::cout << '\n';
-    std::cout << "Total Matches: " << matchCount << std::endl;
+    search_buffer(file.view(), scanOptions, matcher, out, std::cerr);
 
     return EXIT_SUCCESS;
 }
@@ -6,6 +6,10 @@
 #include "arg_parser.h"
 #include "utils.h"
 #include "date.h"
+#include "mapped_file.h"
+#include "matcher.h"
+#include "match_writer.h"
+#include "block_search.h"
 #include <iostream>
 #include <fstream>
 #include <regex>
@@ -17,9 +21,75 @@
 #include <unistd.h>
 #include <string_view>
 #include <cstring>
+#include <deque>
+#include <functional>
+#include <vector>
 
 constexpr int PRE_ALLOCATION_SIZE {512};
 
+/**
+ * Resolves a match destination: stdout for an empty path, otherwise the
+ * given file (truncated).
+ * 
+ * @param path Output file path (-o flag), may be empty.
+ * @param file Stream object that owns the file if one is opened.
+ * @return Stream to write matches to.
+ * @throws std::runtime_error if the file cannot be opened.
+ */
+std::ostream& open_output(const std::string& path, std::ofstream& file);
+
+/**
+ * A piece of a log to search: complete lines plus the number and file offset of its first line.
+ */
+struct LogSegment
+{
+    std::string_view data;
+    int firstLineNumber {1};
+    uint64_t fileOffset {0}; // position of data in its file (byte offsets of --output records)
+    bool continuation {false}; // directly follows the previous segment in the same file (context may span both)
+};
+
+// Supplies segments in order, nullptr at the end; a segment must stay valid until the next call
+// returns, and longer while -B context lines of a continuation may still point into it
+using SegmentSource = std::function<const LogSegment*()>;
+
+/**
+ * Searches an already mapped buffer and prints matches plus the
+ * "Total Matches" summary (text output only; --output jsonl|binary
+ * streams just the records). Shared by the CLI and the query daemon.
+ * options.detectedDateFormat is used as-is when set (cached detection).
+ * 
+ * @param data Mapped log contents (must stay mapped during the call).
+ * @param options Parsed query options.
+ * @param matcher Compiled patterns for these options.
+ * @param out Destination for matches and summary.
+ * @param err Destination for warnings.
+ * @return Number of matches.
+ */
+int search_buffer(std::string_view data, const ProgramOptions& options, const LineMatcher& matcher,
+                  std::ostream& out, std::ostream& err);
+
+/**
+ * Like search_buffer, but over consecutive segments reported as one result
+ * (shared match numbering and summary), e.g. the unread tail of a rotated log
+ * followed by its successor. Context lines do not cross segment boundaries
+ * unless a segment is marked as continuation.
+ * 
+ * @param segments Segments in output order (must stay mapped during the call).
+ * @return Number of matches.
+ */
+int search_segments(const std::vector<LogSegment>& segments, const ProgramOptions& options,
+                    const LineMatcher& matcher, std::ostream& out, std::ostream& err);
+
+/**
+ * Streaming variant for segments produced on the fly (e.g. decompressed blocks).
+ * 
+ * @param nextSegment Segment source, called until it returns nullptr.
+ * @return Number of matches.
+ */
+int search_segments(const SegmentSource& nextSegment, const ProgramOptions& options,
+                    const LineMatcher& matcher, std::ostream& out, std::ostream& err);
+
 /**
  * Memory-mapped log file search with pattern matching and context lines.
  * 
@@ -31,6 +101,8 @@ constexpr int PRE_ALLOCATION_SIZE {512};
  *   - Countdown timer for after-context lines.
  * 4. Deduplication to avoid printing the same line multiple times.
  * 5. Print separators ("--") between close match groups.
+ * 6. Without context lines, search the whole mapping for required literals
+ *    (buffer-level search) and only materialize lines around candidate hits.
  * 
  * @param options Parsed program options.
  * @return EXIT_SUCCESS on completion, EXIT_FAILURE on error.
@@ -0,0 +1,121 @@
+// src/mapped_file.cpp
+
+#include "mapped_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+MappedFile::MappedFile(const std::string& path)
+    : MappedFile(path, 0)
+{
+}
+
+MappedFile::MappedFile(const std::string& path, off_t offset, AccessPattern access)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+
+    struct stat sb;
+    if (fstat(fd, &sb) == -1)
+    {
+        close(fd);
+        throw std::runtime_error("Failed to get file size");
+    }
+    offset = std::clamp<off_t>(offset, 0, sb.st_size);
+    m_size = sb.st_size - offset;
+
+    if (m_size == 0)
+    {
+        close(fd);
+        return;
+    }
+
+    // mmap offsets must be page aligned, the view starts inside the first page
+    off_t alignedOffset {offset - offset % static_cast<off_t>(sysconf(_SC_PAGESIZE))};
+    m_mappingSize = static_cast<size_t>(sb.st_size - alignedOffset);
+
+    // MAP_PRIVATE = Changes won't affect the integrity of file
+    void* mapped = mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, fd, alignedOffset);
+    close(fd);
+
+    if (mapped == MAP_FAILED)
+    {
+        m_mappingSize = 0;
+        throw std::runtime_error("Memory mapping failed");
+    }
+
+    m_mapping = mapped;
+    m_data = static_cast<char*>(mapped) + (offset - alignedOffset);
+    if (access == AccessPattern::SEQUENTIAL)
+    {
+        madvise(m_mapping, m_mappingSize, MADV_SEQUENTIAL | MADV_WILLNEED); // Tell OS to read sequentially
+    }
+    else
+    {
+        madvise(m_mapping, m_mappingSize, MADV_RANDOM); // no readahead beyond the touched pages
+    }
+}
+
+MappedFile::~MappedFile()
+{
+    if (m_mapping != nullptr)
+    {
+        munmap(m_mapping, m_mappingSize);
+    }
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_mapping {std::exchange(other.m_mapping, nullptr)},
+      m_mappingSize {std::exchange(other.m_mappingSize, 0)},
+      m_data {std::exchange(other.m_data, nullptr)},
+      m_size {std::exchange(other.m_size, 0)}
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_mapping != nullptr)
+        {
+            munmap(m_mapping, m_mappingSize);
+        }
+        m_mapping = std::exchange(other.m_mapping, nullptr);
+        m_mappingSize = std::exchange(other.m_mappingSize, 0);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+std::vector<std::string_view> split_line_aligned(std::string_view data, size_t parts)
+{
+    std::vector<std::string_view> slices;
+    if (data.empty())
+    {
+        return slices;
+    }
+
+    parts = parts == 0 ? 1 : parts;
+    size_t target {data.size() / parts};
+    size_t start {0};
+
+    while (start < data.size())
+    {
+        size_t end {data.size()};
+        if (slices.size() + 1 < parts && start + target < data.size())
+        {
+            // Extend the slice to the next newline so no line is cut in half
+            const void* nl = memchr(data.data() + start + target, '\n', data.size() - start - target);
+            end = nl ? static_cast<size_t>(static_cast<const char*>(nl) - data.data()) + 1 : data.size();
+        }
+        slices.push_back(data.substr(start, end - start));
+        start = end;
+    }
+
+    return slices;
+}
@@ -0,0 +1,81 @@
+// src/mapped_file.h
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <vector>
+
+// Access pattern hint given to the kernel for a mapping (readahead behaviour)
+enum class AccessPattern
+{
+    SEQUENTIAL, // full scans: aggressive readahead
+    RANDOM      // sampling: read only the touched pages
+};
+
+/**
+ * Read-only memory mapping of a whole log file (RAII).
+ * The file descriptor is closed right after mapping, the mapping itself
+ * is released when the object goes out of scope.
+ *
+ * Empty files are valid and simply produce an empty view (no mmap call).
+ */
+class MappedFile
+{
+public:
+    /**
+     * Opens and maps the given file.
+     *
+     * @param path Path of the file to map.
+     * @throws std::runtime_error on open, stat or mmap failure.
+     */
+    explicit MappedFile(const std::string& path);
+
+    /**
+     * Maps only the part of the file from `offset` to its end, so a scan of an
+     * appended tail does not touch (or read ahead) the bytes before it.
+     *
+     * @param path Path of the file to map.
+     * @param offset First byte of the view (clamped to the file size).
+     * @param access Readahead hint for the kernel.
+     * @throws std::runtime_error on open, stat or mmap failure.
+     */
+    MappedFile(const std::string& path, off_t offset, AccessPattern access = AccessPattern::SEQUENTIAL);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    const char* data() const { return m_data; }
+    off_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    std::string_view view() const { return {m_data, static_cast<size_t>(m_size)}; }
+
+private:
+    void* m_mapping {nullptr}; // page-aligned start of the mapping
+    size_t m_mappingSize {0};
+    char* m_data {nullptr};    // first byte of the view
+    off_t m_size {0};
+};
+
+/**
+ * Splits a buffer into at most `parts` slices that each start at a line start
+ * and end right after a newline (or at the end of the buffer).
+ * Used to hand independent slices of one mapping to worker threads.
+ *
+ * @param data Buffer to split (typically MappedFile::view()).
+ * @param parts Desired number of slices (>= 1).
+ * @return Non-empty, contiguous slices covering the whole buffer in order.
+ */
+std::vector<std::string_view> split_line_aligned(std::string_view data, size_t parts);
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,141 @@
+// src/match_writer.cpp
+
+#include "match_writer.h"
+
+MatchWriter::MatchWriter(std::ostream& out, int beforeContext, int afterContext)
+    : m_out {out},
+      m_beforeContext {beforeContext},
+      m_afterContext {afterContext}
+{
+}
+
+MatchWriter::MatchWriter(std::ostream& out, int beforeContext, int afterContext, OutputFormat format, const LineMatcher& matcher)
+    : m_out {out},
+      m_format {format},
+      m_matcher {&matcher},
+      m_beforeContext {beforeContext},
+      m_afterContext {afterContext}
+{
+    if (structured())
+    {
+        m_records.reserve(2 * RECORD_BUFFER_SIZE); // headroom for the record that crosses the flush threshold
+    }
+}
+
+void MatchWriter::write_match(int lineNumber, std::string_view line, LogLevel level)
+{
+    if (m_needsSeparator && (m_lastPrintedLine == -1 || lineNumber - m_lastPrintedLine > 1) && !structured())
+    {
+        m_out << m_label << "--\n";
+    }
+
+    for (const auto& [bufLineNum, bufLine, bufOffset] : m_beforeBuffer)
+    {
+        if (bufLineNum > m_lastPrintedLine)
+        {
+            write_line(RecordKind::CONTEXT, bufLineNum, bufLine, LogLevel::UNKNOWN, bufOffset);
+            m_lastPrintedLine = bufLineNum;
+        }
+    }
+
+    write_line(RecordKind::MATCH, lineNumber, line, level, file_offset(line));
+    m_lastPrintedLine = lineNumber;
+    ++m_matchCount;
+
+    m_afterContextRemaining = m_afterContext;
+    m_beforeBuffer.clear();
+    m_needsSeparator = true;
+}
+
+void MatchWriter::write_other(int lineNumber, std::string_view line)
+{
+    if (m_afterContextRemaining > 0)
+    {
+        if (lineNumber > m_lastPrintedLine)
+        {
+            write_line(RecordKind::CONTEXT, lineNumber, line, LogLevel::UNKNOWN, file_offset(line));
+            m_lastPrintedLine = lineNumber;
+        }
+        --m_afterContextRemaining;
+    }
+
+    else if (m_beforeContext > 0)
+    {
+        m_beforeBuffer.push_back({lineNumber, line, file_offset(line)});
+        if (static_cast<int>(m_beforeBuffer.size()) > m_beforeContext)
+        {
+            m_beforeBuffer.pop_front();
+        }
+    }
+}
+
+void MatchWriter::begin_file()
+{
+    m_beforeBuffer.clear();
+    m_afterContextRemaining = 0;
+    m_lastPrintedLine = -1;
+}
+
+void MatchWriter::set_source(std::string_view data, uint64_t fileOffset, const TimestampLayout& dateFormat)
+{
+    m_sourceData = data.data();
+    m_sourceOffset = fileOffset;
+    m_dateFormat = dateFormat;
+}
+
+void MatchWriter::finish()
+{
+    if (!m_records.empty())
+    {
+        m_out.write(m_records.data(), static_cast<std::streamsize>(m_records.size()));
+        m_records.clear();
+    }
+}
+
+void MatchWriter::write_line(RecordKind kind, int lineNumber, std::string_view line, LogLevel level, uint64_t offset)
+{
+    if (structured())
+    {
+        write_record(kind, lineNumber, line, level, offset);
+    }
+    else if (kind == RecordKind::MATCH)
+    {
+        auto color = get_log_level_color(level);
+        m_out << color << m_label << "[" << static_cast<int>(level) << ":L" << lineNumber << "] " << line << RESET_COLOR << '\n';
+    }
+    else
+    {
+        m_out << CONTEXT_COLOR << m_label << "[C:L" << lineNumber << "] " << line << RESET_COLOR << '\n';
+    }
+}
+
+void MatchWriter::write_record(RecordKind kind, int lineNumber, std::string_view line, LogLevel level, uint64_t offset)
+{
+    MatchRecord record;
+    record.kind = kind;
+    record.lineNumber = static_cast<uint64_t>(lineNumber);
+    record.offset = offset;
+    record.level = level;
+    record.line = line;
+
+    if (auto ts {extract_timestamp(line, m_dateFormat)})
+    {
+        record.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(ts->time_since_epoch()).count();
+    }
+
+    if (kind == RecordKind::MATCH)
+    {
+        record.patternIndex = m_matcher->locate(line, m_spans);
+        record.spans = m_spans;
+    }
+
+    if (m_format == OutputFormat::JSONL)
+        append_jsonl_record(m_records, record);
+    else
+        append_binary_record(m_records, record);
+
+    if (m_records.size() >= RECORD_BUFFER_SIZE)
+    {
+        finish();
+    }
+}
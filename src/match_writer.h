@@ -0,0 +1,150 @@
+// src/match_writer.h
+
+#ifndef MATCH_WRITER_H
+#define MATCH_WRITER_H
+
+#include "utils.h"
+#include "date.h"
+#include "matcher.h"
+#include "record_format.h"
+#include <deque>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+constexpr const char* CONTEXT_COLOR = "\033[2m"; // dim
+
+/**
+ * Prints matches of one query with grep-style context lines.
+ * 
+ * Owns the per-query context state so several queries can share one scan:
+ *   - Ring buffer (deque) for before-context lines (-B).
+ *   - Countdown timer for after-context lines (-A).
+ *   - Last printed line number for deduplication.
+ *   - "--" separators between non-adjacent match groups.
+ * 
+ * Buffered lines are string_views into the mapped file, so the mapping
+ * must outlive the writer.
+ *
+ * With --output jsonl|binary, lines are serialized as records (see
+ * record_format.h) into a reused buffer that is written in RECORD_BUFFER_SIZE
+ * chunks; finish() writes the remainder.
+ */
+class MatchWriter
+{
+public:
+    /**
+     * @param out Destination stream (stdout or a per-query file).
+     * @param beforeContext Number of lines to show before a match (-B).
+     * @param afterContext Number of lines to show after a match (-A).
+     */
+    MatchWriter(std::ostream& out, int beforeContext, int afterContext);
+
+    /**
+     * @param out Destination stream (stdout or a per-query file).
+     * @param beforeContext Number of lines to show before a match (-B).
+     * @param afterContext Number of lines to show after a match (-A).
+     * @param format Output format (--output).
+     * @param matcher Matcher of the query, used for pattern index and spans of
+     *                structured records (must outlive the writer).
+     */
+    MatchWriter(std::ostream& out, int beforeContext, int afterContext, OutputFormat format, const LineMatcher& matcher);
+
+    /**
+     * Describes the buffer the following lines come from, for the byte offset
+     * and timestamp fields of structured records (unused for text output).
+     * 
+     * @param data Buffer the lines are views into.
+     * @param fileOffset Position of data in the file.
+     * @param dateFormat Timestamp layout of the lines (unknown = no timestamps).
+     */
+    void set_source(std::string_view data, uint64_t fileOffset, const TimestampLayout& dateFormat);
+
+    /**
+     * Prefixes every text line (matches, context, "--" separators) with a label,
+     * e.g. "[Q2] " when several queries share stdout.
+     *
+     * @param label Prefix, printed as-is.
+     */
+    void set_label(std::string label) { m_label = std::move(label); }
+
+    /**
+     * Writes records still buffered (structured output). Call once after the scan.
+     */
+    void finish();
+
+    /**
+     * Prints a matching line, preceded by buffered before-context lines.
+     * 
+     * @param lineNumber 1-based line number.
+     * @param line Line content.
+     * @param level Detected log level (selects color and tag).
+     */
+    void write_match(int lineNumber, std::string_view line, LogLevel level);
+
+    /**
+     * Feeds a non-matching line: printed as after-context or kept as before-context.
+     * Can be skipped entirely while wants_other_lines() is false.
+     * 
+     * @param lineNumber 1-based line number.
+     * @param line Line content.
+     */
+    void write_other(int lineNumber, std::string_view line);
+
+    /**
+     * @return true if non-matching lines can still end up in the output.
+     */
+    bool wants_other_lines() const { return m_beforeContext > 0 || m_afterContextRemaining > 0; }
+
+    /**
+     * Starts a new file (e.g. a rotated log followed by its successor): context
+     * never spans the boundary and line numbers may restart, while the match
+     * count and "--" separators continue.
+     */
+    void begin_file();
+
+    int match_count() const { return m_matchCount; }
+    std::ostream& stream() { return m_out; }
+    bool structured() const { return m_format != OutputFormat::TEXT; }
+
+private:
+    // Buffered before-context line; its offset is taken while its segment is still the source
+    struct BufferedLine
+    {
+        int lineNumber {0};
+        std::string_view line;
+        uint64_t offset {0};
+    };
+
+    uint64_t file_offset(std::string_view line) const
+    {
+        return m_sourceOffset + (m_sourceData ? static_cast<uint64_t>(line.data() - m_sourceData) : 0);
+    }
+
+    void write_line(RecordKind kind, int lineNumber, std::string_view line, LogLevel level, uint64_t offset);
+    void write_record(RecordKind kind, int lineNumber, std::string_view line, LogLevel level, uint64_t offset);
+
+    std::ostream& m_out;
+    OutputFormat m_format {OutputFormat::TEXT};
+    const LineMatcher* m_matcher {nullptr};
+    int m_beforeContext {0};
+    int m_afterContext {0};
+
+    std::deque<BufferedLine> m_beforeBuffer; // Ring buffer for before-context lines
+    int m_afterContextRemaining {0}; // Countdown timer for after-context lines
+    int m_lastPrintedLine {-1};      // Deduplication tracker
+    bool m_needsSeparator {false};
+    int m_matchCount {0};
+    std::string m_label;             // text line prefix (see set_label())
+
+    // Structured output state
+    std::string m_records;          // serialized records not yet written
+    std::vector<MatchSpan> m_spans; // reused for every match
+    const char* m_sourceData {nullptr};
+    uint64_t m_sourceOffset {0};
+    TimestampLayout m_dateFormat {};
+};
+
+#endif // MATCH_WRITER_H
@@ -0,0 +1,121 @@
+// src/matcher.cpp
+
+#include "matcher.h"
+#include "regex_literals.h"
+#include <cctype>
+
+namespace
+{
+    size_t find_case_insensitive(std::string_view haystack, std::string_view needle, size_t from)
+    {
+        auto it = std::search(haystack.begin() + from, haystack.end(),
+                              needle.begin(), needle.end(),
+                              [](char ch1, char ch2) { return std::tolower(ch1) == std::tolower(ch2); });
+
+        return it == haystack.end() ? std::string_view::npos : static_cast<size_t>(it - haystack.begin());
+    }
+}
+
+LineMatcher::LineMatcher(const ProgramOptions& options)
+    : m_patterns {options.searchPatterns},
+      m_caseInsensitive {options.caseInsensitive},
+      m_useRegex {options.useRegex}
+{
+    if (m_useRegex)
+    {
+        m_regexPatterns.reserve(m_patterns.size());
+
+        for (const auto& pattern : m_patterns)
+        {
+            m_regexPatterns.emplace_back(pattern, m_caseInsensitive ? std::regex::icase : std::regex::ECMAScript);
+            m_regexLiterals.push_back(extract_required_literals(pattern));
+        }
+    }
+}
+
+bool LineMatcher::matches(std::string_view line) const
+{
+    if (m_useRegex)
+    {
+        return matches_as<MatchKind::REGEX, false>(line);
+    }
+    return m_caseInsensitive
+        ? matches_as<MatchKind::LITERAL, true>(line)
+        : matches_as<MatchKind::LITERAL, false>(line);
+}
+
+int LineMatcher::locate(std::string_view line, std::vector<MatchSpan>& spans) const
+{
+    spans.clear();
+
+    for (size_t i = 0; i < m_patterns.size(); ++i)
+    {
+        if (m_useRegex)
+        {
+            using SpanIterator = std::regex_iterator<std::string_view::const_iterator>;
+            for (SpanIterator it(line.begin(), line.end(), m_regexPatterns[i]), end; it != end; ++it)
+            {
+                uint32_t begin {static_cast<uint32_t>(it->position())};
+                spans.push_back({begin, begin + static_cast<uint32_t>(it->length())});
+            }
+        }
+        else
+        {
+            std::string_view pattern {m_patterns[i]};
+            if (pattern.empty())
+            {
+                return static_cast<int>(i); // matches everywhere, no meaningful span
+            }
+
+            size_t pos {0};
+            while (true)
+            {
+                pos = m_caseInsensitive ? find_case_insensitive(line, pattern, pos) : line.find(pattern, pos);
+                if (pos == std::string_view::npos)
+                {
+                    break;
+                }
+                spans.push_back({static_cast<uint32_t>(pos), static_cast<uint32_t>(pos + pattern.size())});
+                pos += pattern.size();
+            }
+        }
+
+        if (!spans.empty())
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+std::optional<std::vector<std::string>> LineMatcher::required_literals() const
+{
+    if (m_patterns.empty())
+    {
+        return std::nullopt;
+    }
+
+    if (m_useRegex)
+    {
+        // A line can only match if it contains a required literal of some regex
+        std::vector<std::string> literals;
+        for (const auto& regexLiterals : m_regexLiterals)
+        {
+            if (!regexLiterals)
+            {
+                return std::nullopt; // one regex without literals makes every line a candidate
+            }
+            literals.insert(literals.end(), regexLiterals->begin(), regexLiterals->end());
+        }
+        return literals;
+    }
+
+    for (const auto& pattern : m_patterns)
+    {
+        if (pattern.empty())
+        {
+            return std::nullopt; // empty literal matches every line
+        }
+    }
+    return m_patterns;
+}
@@ -0,0 +1,162 @@
+// src/matcher.h
+
+#ifndef MATCHER_H
+#define MATCHER_H
+
+#include "arg_parser.h"
+#include "utils.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <regex>
+#include <optional>
+#include <cstdint>
+
+// Matching strategy, used as template parameter of the specialized scan loops
+enum class MatchKind
+{
+    LITERAL,
+    REGEX
+};
+
+// Byte range [begin, end) of a pattern occurrence within a line
+struct MatchSpan
+{
+    uint32_t begin;
+    uint32_t end;
+};
+
+/**
+ * Line matcher built once from the program options.
+ * Wraps literal, case-insensitive and regex (-r) matching behind a single call,
+ * so every scan mode (search, --patterns, ...) shares the same semantics.
+ *
+ * Regex patterns are compiled in the constructor together with their required
+ * literals (see extract_required_literals()), which gate the regex per line.
+ * Matching never copies the line.
+ * A const LineMatcher is safe to share between threads.
+ */
+class LineMatcher
+{
+public:
+    /**
+     * Compiles the search patterns of the given options.
+     *
+     * @param options Parsed program options (patterns, -i, -r).
+     * @throws std::regex_error on malformed regex (already validated by parse_arguments()).
+     */
+    explicit LineMatcher(const ProgramOptions& options);
+
+    /**
+     * Checks whether the line matches any of the search patterns.
+     * An empty pattern list matches every line.
+     *
+     * @param line Line content without the trailing newline.
+     * @return true if at least one pattern matches.
+     */
+    bool matches(std::string_view line) const;
+
+    /**
+     * Same as matches(), with the strategy fixed at compile time so hot loops
+     * carry no per-line -r / -i branches. Kind and CaseFold must agree with
+     * kind() and case_insensitive() (CaseFold is ignored for regex, -i is compiled in).
+     */
+    template <MatchKind Kind, bool CaseFold>
+    bool matches_as(std::string_view line) const
+    {
+        if (m_patterns.empty())
+        {
+            return true;
+        }
+
+        if constexpr (Kind == MatchKind::REGEX)
+        {
+            for (size_t i = 0; i < m_regexPatterns.size(); ++i)
+            {
+                // Cheap required-literal check first, the regex only runs on lines that pass
+                if (!passes_prefilter(m_regexLiterals[i], line))
+                {
+                    continue;
+                }
+
+                // Iterator overload searches the mapped bytes directly (no std::string copy)
+                if (std::regex_search(line.begin(), line.end(), m_regexPatterns[i]))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        else
+        {
+            // Pure string_view matching - NO allocations!
+            for (const auto& pattern : m_patterns)
+            {
+                bool match {};
+                if constexpr (CaseFold)
+                    match = contains_case_insensitive(line, pattern);
+                else
+                    match = line.find(pattern) != std::string_view::npos;
+
+                if (match)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+
+    /**
+     * Finds which pattern matches a line and where (for structured output).
+     * Only called for lines that matches() accepted, so it may be slower.
+     *
+     * @param line Line content without the trailing newline.
+     * @param spans Receives the non-overlapping occurrences of the returned
+     *              pattern (cleared first, capacity reused between calls).
+     * @return Index of the first matching pattern, or -1 if none matches.
+     */
+    int locate(std::string_view line, std::vector<MatchSpan>& spans) const;
+
+    /**
+     * Literals of which at least one must occur in every matching line
+     * (compared case-insensitively when caseInsensitive() is set).
+     * Used to build shared prefilters; matches() still decides the final result.
+     *
+     * @return The literal set, or std::nullopt if no such set is known (every line is a candidate).
+     */
+    std::optional<std::vector<std::string>> required_literals() const;
+
+    bool case_insensitive() const { return m_caseInsensitive; }
+    MatchKind kind() const { return m_useRegex ? MatchKind::REGEX : MatchKind::LITERAL; }
+
+private:
+    bool passes_prefilter(const std::optional<std::vector<std::string>>& literals, std::string_view line) const
+    {
+        if (!literals)
+        {
+            return true;
+        }
+
+        for (const auto& literal : *literals)
+        {
+            bool found = m_caseInsensitive
+                ? contains_case_insensitive(line, literal)
+                : line.find(literal) != std::string_view::npos;
+
+            if (found)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::string> m_patterns;
+    std::vector<std::regex> m_regexPatterns;
+    std::vector<std::optional<std::vector<std::string>>> m_regexLiterals; // required literals per regex
+    bool m_caseInsensitive {false};
+    bool m_useRegex {false};
+};
+
+#endif // MATCHER_H
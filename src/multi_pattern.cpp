@@ -0,0 +1,131 @@
+// src/multi_pattern.cpp
+
+#include "multi_pattern.h"
+#include <queue>
+#include <stdexcept>
+
+namespace
+{
+    inline unsigned char fold_ascii(unsigned char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c - 'A' + 'a') : c;
+    }
+}
+
+MultiPatternMatcher::MultiPatternMatcher(const std::vector<std::string>& patterns, bool caseInsensitive)
+    : m_patternCount {patterns.size()}
+{
+    // 1. Byte classes: class 0 = bytes that never appear in a pattern
+    std::array<int, 256> classOfFolded {};
+    classOfFolded.fill(-1);
+    uint32_t classCount {1};
+
+    for (const auto& pattern : patterns)
+    {
+        for (unsigned char c : pattern)
+        {
+            unsigned char key {caseInsensitive ? fold_ascii(c) : c};
+            if (classOfFolded[key] == -1)
+            {
+                classOfFolded[key] = static_cast<int>(classCount++);
+            }
+        }
+    }
+
+    if (classCount > 256)
+    {
+        throw std::runtime_error("Too many distinct bytes in multi-pattern matcher");
+    }
+
+    for (int byte = 0; byte < 256; ++byte)
+    {
+        unsigned char key {caseInsensitive ? fold_ascii(static_cast<unsigned char>(byte)) : static_cast<unsigned char>(byte)};
+        m_byteClass[byte] = static_cast<uint8_t>(classOfFolded[key] == -1 ? 0 : classOfFolded[key]);
+    }
+
+    // 2. Trie (goto function), -1 = no edge
+    std::vector<std::vector<int32_t>> trie(1, std::vector<int32_t>(classCount, -1));
+    std::vector<std::vector<uint32_t>> outputs(1);
+
+    for (uint32_t index = 0; index < patterns.size(); ++index)
+    {
+        const auto& pattern {patterns[index]};
+        if (pattern.empty())
+        {
+            m_emptyPatterns.push_back(index);
+            continue;
+        }
+
+        size_t state {0};
+        for (unsigned char c : pattern)
+        {
+            uint8_t cls {m_byteClass[c]};
+            if (trie[state][cls] == -1)
+            {
+                trie[state][cls] = static_cast<int32_t>(trie.size());
+                trie.emplace_back(classCount, -1);
+                outputs.emplace_back();
+            }
+            state = static_cast<size_t>(trie[state][cls]);
+        }
+        outputs[state].push_back(index);
+    }
+
+    if (trie.size() == 1)
+    {
+        return; // only empty patterns (or none): nothing to scan for
+    }
+
+    // 3. BFS over the trie: failure links turn it into a full DFA
+    size_t stateCount {trie.size()};
+    m_classCount = classCount;
+    m_transitions.assign(stateCount * classCount, 0);
+    std::vector<uint32_t> fail(stateCount, 0);
+    std::queue<uint32_t> pending;
+
+    for (uint32_t cls = 0; cls < classCount; ++cls)
+    {
+        int32_t next {trie[0][cls]};
+        if (next != -1)
+        {
+            m_transitions[cls] = static_cast<uint32_t>(next);
+            pending.push(static_cast<uint32_t>(next));
+        }
+    }
+
+    while (!pending.empty())
+    {
+        uint32_t state {pending.front()};
+        pending.pop();
+
+        // Inherit matches that end at the failure state (suffix patterns)
+        const auto& inherited {outputs[fail[state]]};
+        outputs[state].insert(outputs[state].end(), inherited.begin(), inherited.end());
+
+        for (uint32_t cls = 0; cls < classCount; ++cls)
+        {
+            int32_t next {trie[state][cls]};
+            uint32_t fallback {m_transitions[fail[state] * classCount + cls]};
+
+            if (next == -1)
+            {
+                m_transitions[state * classCount + cls] = fallback;
+            }
+            else
+            {
+                fail[next] = fallback;
+                m_transitions[state * classCount + cls] = static_cast<uint32_t>(next);
+                pending.push(static_cast<uint32_t>(next));
+            }
+        }
+    }
+
+    // 4. Flatten outputs (CSR)
+    m_outputStart.reserve(stateCount + 1);
+    for (const auto& stateOutputs : outputs)
+    {
+        m_outputStart.push_back(static_cast<uint32_t>(m_outputs.size()));
+        m_outputs.insert(m_outputs.end(), stateOutputs.begin(), stateOutputs.end());
+    }
+    m_outputStart.push_back(static_cast<uint32_t>(m_outputs.size()));
+}
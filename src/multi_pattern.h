@@ -0,0 +1,89 @@
+// src/multi_pattern.h
+
+#ifndef MULTI_PATTERN_H
+#define MULTI_PATTERN_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Aho-Corasick multi-literal matcher compiled into a dense DFA.
+ * Finds every occurrence of every pattern in a single left-to-right pass,
+ * one table lookup per input byte regardless of the number of patterns.
+ *
+ * Input bytes are first mapped to a small set of byte classes (one per byte
+ * that appears in a pattern, plus one for "anything else"), which keeps the
+ * transition table small. With caseInsensitive the classes fold ASCII case.
+ */
+class MultiPatternMatcher
+{
+public:
+    MultiPatternMatcher() = default;
+
+    /**
+     * Builds the automaton.
+     *
+     * @param patterns Literals to search for (empty literals match at offset 0).
+     * @param caseInsensitive Fold ASCII case of patterns and input.
+     */
+    MultiPatternMatcher(const std::vector<std::string>& patterns, bool caseInsensitive);
+
+    /**
+     * Reports every pattern occurrence in text, in order of end position.
+     *
+     * @param text Text to scan.
+     * @param onMatch Called as onMatch(patternIndex, endOffset) where endOffset is one
+     *                past the last matched byte; return false to stop scanning.
+     */
+    template <typename Callback>
+    void scan(std::string_view text, Callback&& onMatch) const
+    {
+        for (uint32_t pattern : m_emptyPatterns)
+        {
+            if (!onMatch(pattern, size_t {0}))
+                return;
+        }
+
+        if (m_classCount == 0)
+            return;
+
+        uint32_t state {0};
+        const auto* bytes = reinterpret_cast<const unsigned char*>(text.data());
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            state = m_transitions[state * m_classCount + m_byteClass[bytes[i]]];
+            for (uint32_t k = m_outputStart[state]; k < m_outputStart[state + 1]; ++k)
+            {
+                if (!onMatch(m_outputs[k], i + 1))
+                    return;
+            }
+        }
+    }
+
+    /**
+     * @return true if any pattern occurs in text.
+     */
+    bool contains_any(std::string_view text) const
+    {
+        bool found {false};
+        scan(text, [&](uint32_t, size_t) { found = true; return false; });
+        return found;
+    }
+
+    size_t pattern_count() const { return m_patternCount; }
+    bool empty() const { return m_patternCount == 0; }
+
+private:
+    std::array<uint8_t, 256> m_byteClass {};
+    uint32_t m_classCount {0};
+    std::vector<uint32_t> m_transitions;   // state * m_classCount + class -> state
+    std::vector<uint32_t> m_outputStart;   // CSR offsets into m_outputs (states + 1 entries)
+    std::vector<uint32_t> m_outputs;       // pattern indices ending in each state
+    std::vector<uint32_t> m_emptyPatterns; // patterns of length 0
+    size_t m_patternCount {0};
+};
+
+#endif // MULTI_PATTERN_H
@@ -0,0 +1,607 @@
+// src/pack.cpp
+
+#include "pack.h"
+#include "file_processor.h"
+#include <array>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <lzma.h>
+#include <thread>
+
+namespace
+{
+    constexpr size_t TRIGRAM_SPACE {1 << 24}; // every possible 3-byte value
+
+    struct BlockMeta
+    {
+        uint64_t compressedSize {0};
+        uint64_t uncompressedSize {0};
+        uint32_t lineCount {0};
+        uint8_t levelBitmap {0};
+        uint8_t flags {0};
+        int64_t minTimestampMs {std::numeric_limits<int64_t>::max()};
+        int64_t maxTimestampMs {std::numeric_limits<int64_t>::min()};
+        std::array<uint8_t, PACK_BLOOM_BYTES> bloom {};
+    };
+
+    // Block as found in an archive: metadata plus where its payload and text live
+    struct PackedBlock
+    {
+        BlockMeta meta;
+        const char* payload {nullptr};
+        uint64_t originalOffset {0}; // byte offset in the original log
+        int firstLineNumber {1};
+    };
+
+    inline unsigned char fold_case(unsigned char c)
+    {
+        return (c >= 'A' && c <= 'Z') ? static_cast<unsigned char>(c + ('a' - 'A')) : c;
+    }
+
+    // Bit positions of a case-folded trigram in the bloom filter (double hashing)
+    template <typename F>
+    void for_each_bloom_bit(uint32_t trigram, F&& onBit)
+    {
+        uint64_t hash {trigram};
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ULL;
+        hash ^= hash >> 33;
+
+        uint32_t h1 {static_cast<uint32_t>(hash)};
+        uint32_t h2 {static_cast<uint32_t>(hash >> 32) | 1};
+        for (uint32_t k = 0; k < PACK_BLOOM_HASHES; ++k)
+        {
+            onBit((h1 + k * h2) % (PACK_BLOOM_BYTES * 8));
+        }
+    }
+
+    // Whether every trigram of the (case-folded) literal is in the bloom filter
+    bool bloom_may_contain(const BlockMeta& meta, std::string_view literal)
+    {
+        if (literal.size() < 3)
+        {
+            return true; // too short to rule out
+        }
+
+        uint32_t trigram {0};
+        for (size_t i = 0; i < literal.size(); ++i)
+        {
+            trigram = ((trigram << 8) | fold_case(static_cast<unsigned char>(literal[i]))) & 0xFFFFFF;
+            if (i < 2)
+            {
+                continue;
+            }
+
+            bool present {true};
+            for_each_bloom_bit(trigram, [&](uint32_t bit) {
+                present &= (meta.bloom[bit / 8] & (1u << (bit % 8))) != 0;
+            });
+            if (!present)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Line count, levels, timestamp range and trigram bloom of one block
+    BlockMeta analyze_block(std::string_view text, const TimestampLayout& dateFormat, std::vector<uint64_t>& seenTrigrams)
+    {
+        BlockMeta meta;
+        meta.uncompressedSize = text.size();
+
+        const char* lineStart {text.data()};
+        const char* textEnd {text.data() + text.size()};
+        while (lineStart < textEnd)
+        {
+            const char* lineEnd {static_cast<const char*>(memchr(lineStart, '\n', textEnd - lineStart))};
+            lineEnd = lineEnd ? lineEnd : textEnd;
+
+            off_t lineLength {lineEnd - lineStart};
+            if (lineLength > 0 && lineStart[lineLength - 1] == '\r')
+            {
+                --lineLength;
+            }
+            std::string_view lineView(lineStart, lineLength);
+            lineStart = lineEnd + 1;
+            ++meta.lineCount;
+
+            meta.levelBitmap |= static_cast<uint8_t>(log_level_bit(detect_log_level(lineView, DEFAULT_LOG_LEVEL_CONFIG)));
+
+            auto ts {find_timestamp(lineView, dateFormat)};
+            if (!ts)
+            {
+                meta.flags |= PACK_FLAG_UNDATED_LINES;
+                continue;
+            }
+            if (!ts->absolute)
+            {
+                meta.flags |= PACK_FLAG_LOCAL_TIMES;
+            }
+            int64_t ms {std::chrono::duration_cast<std::chrono::milliseconds>(ts->time.time_since_epoch()).count()};
+            meta.minTimestampMs = std::min(meta.minTimestampMs, ms);
+            meta.maxTimestampMs = std::max(meta.maxTimestampMs, ms);
+        }
+
+        // Each distinct trigram is hashed once (seen set over all 2^24 values)
+        std::fill(seenTrigrams.begin(), seenTrigrams.end(), 0);
+        uint32_t trigram {0};
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            trigram = ((trigram << 8) | fold_case(static_cast<unsigned char>(text[i]))) & 0xFFFFFF;
+            if (i < 2 || (seenTrigrams[trigram / 64] & (1ULL << (trigram % 64))))
+            {
+                continue;
+            }
+            seenTrigrams[trigram / 64] |= 1ULL << (trigram % 64);
+            for_each_bloom_bit(trigram, [&](uint32_t bit) { meta.bloom[bit / 8] |= static_cast<uint8_t>(1u << (bit % 8)); });
+        }
+        return meta;
+    }
+
+    // Splits the log into blocks of about PACK_BLOCK_SIZE bytes, cut after a newline
+    std::vector<std::string_view> split_blocks(std::string_view data)
+    {
+        std::vector<std::string_view> blocks;
+        size_t start {0};
+        while (start < data.size())
+        {
+            size_t end {std::min(start + PACK_BLOCK_SIZE, data.size())};
+            if (end < data.size())
+            {
+                size_t cut {data.rfind('\n', end - 1)};
+                if (cut == std::string_view::npos || cut < start)
+                {
+                    cut = data.find('\n', end); // line longer than a block
+                }
+                end = cut == std::string_view::npos ? data.size() : cut + 1;
+            }
+            blocks.push_back(data.substr(start, end - start));
+            start = end;
+        }
+        return blocks;
+    }
+
+    // Runs job(i) for i in [0, count) on up to `threads` threads, rethrowing the first error
+    template <typename Job>
+    void run_parallel(size_t count, size_t threads, Job&& job)
+    {
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < std::min(count, threads); ++t)
+        {
+            workers.emplace_back([&, t]() {
+                for (size_t i = t; i < count; i += threads)
+                {
+                    try
+                    {
+                        job(i);
+                    }
+                    catch (...)
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        for (const auto& error : errors)
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    template <typename T>
+    void write_little_endian(std::ostream& out, T value)
+    {
+        char bytes[sizeof(T)];
+        auto bits {static_cast<std::make_unsigned_t<T>>(value)};
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            bytes[i] = static_cast<char>((bits >> (8 * i)) & 0xFF);
+        }
+        out.write(bytes, sizeof(T));
+    }
+
+    template <typename T>
+    T read_little_endian(const char* data)
+    {
+        std::make_unsigned_t<T> bits {0};
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            bits |= static_cast<std::make_unsigned_t<T>>(static_cast<unsigned char>(data[i])) << (8 * i);
+        }
+        return static_cast<T>(bits);
+    }
+
+    void write_block_header(std::ostream& out, const BlockMeta& meta)
+    {
+        write_little_endian(out, meta.compressedSize);
+        write_little_endian(out, meta.uncompressedSize);
+        write_little_endian(out, meta.lineCount);
+        write_little_endian(out, meta.levelBitmap);
+        write_little_endian(out, meta.flags);
+        write_little_endian(out, uint16_t {0});
+        write_little_endian(out, meta.minTimestampMs);
+        write_little_endian(out, meta.maxTimestampMs);
+        out.write(reinterpret_cast<const char*>(meta.bloom.data()), PACK_BLOOM_BYTES);
+    }
+
+    BlockMeta read_block_header(const char* data)
+    {
+        BlockMeta meta;
+        meta.compressedSize = read_little_endian<uint64_t>(data);
+        meta.uncompressedSize = read_little_endian<uint64_t>(data + 8);
+        meta.lineCount = read_little_endian<uint32_t>(data + 16);
+        meta.levelBitmap = read_little_endian<uint8_t>(data + 20);
+        meta.flags = read_little_endian<uint8_t>(data + 21);
+        meta.minTimestampMs = read_little_endian<int64_t>(data + 24);
+        meta.maxTimestampMs = read_little_endian<int64_t>(data + 32);
+        std::memcpy(meta.bloom.data(), data + 40, PACK_BLOOM_BYTES);
+        return meta;
+    }
+
+    std::string compress_block(std::string_view text)
+    {
+        std::string compressed(lzma_stream_buffer_bound(text.size()), '\0');
+        size_t written {0};
+        lzma_ret result {lzma_easy_buffer_encode(PACK_COMPRESSION_PRESET, LZMA_CHECK_CRC64, nullptr,
+                                                 reinterpret_cast<const uint8_t*>(text.data()), text.size(),
+                                                 reinterpret_cast<uint8_t*>(compressed.data()), &written, compressed.size())};
+        if (result != LZMA_OK)
+        {
+            throw std::runtime_error("Block compression failed (lzma error " + std::to_string(result) + ")");
+        }
+        compressed.resize(written);
+        return compressed;
+    }
+
+    std::string decompress_block(const PackedBlock& block)
+    {
+        std::string text(block.meta.uncompressedSize, '\0');
+        uint64_t memoryLimit {std::numeric_limits<uint64_t>::max()};
+        size_t inputPos {0};
+        size_t outputPos {0};
+        lzma_ret result {lzma_stream_buffer_decode(&memoryLimit, 0, nullptr,
+                                                   reinterpret_cast<const uint8_t*>(block.payload), &inputPos, block.meta.compressedSize,
+                                                   reinterpret_cast<uint8_t*>(text.data()), &outputPos, text.size())};
+        if (result != LZMA_OK || outputPos != text.size())
+        {
+            throw std::runtime_error("Corrupt archive block at original offset " + std::to_string(block.originalOffset));
+        }
+        return text;
+    }
+
+    // Block index of a mapped archive (headers only, payloads stay compressed)
+    std::vector<PackedBlock> read_index(std::string_view archive, TimestampLayout& dateFormat, uint64_t& originalSize)
+    {
+        if (archive.size() < PACK_FILE_HEADER_SIZE || archive.compare(0, 4, std::string_view(PACK_MAGIC, 4)) != 0)
+        {
+            throw std::runtime_error("Not an .lpk archive");
+        }
+        if (read_little_endian<uint32_t>(archive.data() + 4) != PACK_VERSION)
+        {
+            throw std::runtime_error("Unsupported .lpk version");
+        }
+
+        uint8_t storedFormat {read_little_endian<uint8_t>(archive.data() + 12)};
+        dateFormat.format = storedFormat <= static_cast<uint8_t>(LogDateFormat::UNKNOWN)
+            ? static_cast<LogDateFormat>(storedFormat)
+            : LogDateFormat::UNKNOWN;
+        dateFormat.column = read_little_endian<uint16_t>(archive.data() + 14);
+        originalSize = read_little_endian<uint64_t>(archive.data() + 16);
+        uint64_t blockCount {read_little_endian<uint64_t>(archive.data() + 24)};
+
+        std::vector<PackedBlock> blocks;
+        size_t pos {PACK_FILE_HEADER_SIZE};
+        uint64_t originalOffset {0};
+        int lineNumber {1};
+
+        for (uint64_t b = 0; b < blockCount; ++b)
+        {
+            if (archive.size() - pos < PACK_BLOCK_HEADER_SIZE)
+            {
+                throw std::runtime_error("Truncated .lpk archive");
+            }
+
+            PackedBlock block;
+            block.meta = read_block_header(archive.data() + pos);
+            pos += PACK_BLOCK_HEADER_SIZE;
+            if (archive.size() - pos < block.meta.compressedSize)
+            {
+                throw std::runtime_error("Truncated .lpk archive");
+            }
+
+            block.payload = archive.data() + pos;
+            block.originalOffset = originalOffset;
+            block.firstLineNumber = lineNumber;
+            pos += block.meta.compressedSize;
+            originalOffset += block.meta.uncompressedSize;
+            lineNumber += static_cast<int>(block.meta.lineCount);
+            blocks.push_back(block);
+        }
+        return blocks;
+    }
+}
+
+bool is_pack_file(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    char header[PACK_FILE_HEADER_SIZE] {};
+    return file.read(header, sizeof(header)) && std::equal(header, header + sizeof(PACK_MAGIC), PACK_MAGIC)
+        && read_little_endian<uint32_t>(header + 4) == PACK_VERSION;
+}
+
+int pack_log(const std::string& inputPath, const std::string& outputPath, int threads)
+{
+    MappedFile input(inputPath);
+    std::string_view data {input.view()};
+    TimestampLayout dateFormat {detect_timestamp_layout(data)};
+
+    std::ofstream out(outputPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+    {
+        throw std::runtime_error("Failed to open output file: " + outputPath);
+    }
+
+    std::vector<std::string_view> blocks {split_blocks(data)};
+
+    out.write(PACK_MAGIC, sizeof(PACK_MAGIC));
+    write_little_endian(out, PACK_VERSION);
+    write_little_endian(out, static_cast<uint32_t>(PACK_BLOCK_SIZE));
+    write_little_endian(out, static_cast<uint8_t>(dateFormat.format));
+    write_little_endian(out, uint8_t {0});
+    write_little_endian(out, dateFormat.column);
+    write_little_endian(out, static_cast<uint64_t>(data.size()));
+    write_little_endian(out, static_cast<uint64_t>(blocks.size()));
+
+    // Batches of one block per worker, written in order
+    size_t workerCount {resolve_thread_count(threads)};
+    std::vector<std::vector<uint64_t>> seenTrigrams(workerCount, std::vector<uint64_t>(TRIGRAM_SPACE / 64));
+    uint64_t totalLines {0};
+
+    for (size_t batchStart = 0; batchStart < blocks.size(); batchStart += workerCount)
+    {
+        size_t batchSize {std::min(workerCount, blocks.size() - batchStart)};
+        std::vector<BlockMeta> metas(batchSize);
+        std::vector<std::string> payloads(batchSize);
+
+        run_parallel(batchSize, workerCount, [&](size_t i) {
+            std::string_view text {blocks[batchStart + i]};
+            metas[i] = analyze_block(text, dateFormat, seenTrigrams[i]);
+            payloads[i] = compress_block(text);
+            metas[i].compressedSize = payloads[i].size();
+        });
+
+        for (size_t i = 0; i < batchSize; ++i)
+        {
+            write_block_header(out, metas[i]);
+            out.write(payloads[i].data(), static_cast<std::streamsize>(payloads[i].size()));
+            totalLines += metas[i].lineCount;
+        }
+    }
+
+    out.flush();
+    if (!out)
+    {
+        throw std::runtime_error("Failed to write archive: " + outputPath);
+    }
+
+    double packedSize {static_cast<double>(out.tellp())};
+    std::cout << "Packed " << totalLines << " lines into " << blocks.size() << " blocks: "
+              << data.size() << " -> " << static_cast<uint64_t>(packedSize) << " bytes";
+    if (packedSize > 0)
+    {
+        std::cout << " (" << std::fixed << std::setprecision(2) << static_cast<double>(data.size()) / packedSize << "x)";
+    }
+    std::cout << std::endl;
+
+    return EXIT_SUCCESS;
+}
+
+int run_pack_command(int argc, char* argv[])
+{
+    std::vector<std::string> paths;
+    int threads {0};
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg {argv[i]};
+        if (arg == "--threads")
+        {
+            if (i + 1 >= argc)
+            {
+                throw std::runtime_error("Missing value after --threads flag.");
+            }
+
+            try
+            {
+                threads = std::stoi(argv[++i]);
+            }
+
+            catch (const std::exception&)
+            {
+                throw std::runtime_error("Invalid integer value for --threads flag: " + std::string(argv[i]));
+            }
+        }
+        else
+        {
+            paths.push_back(std::move(arg));
+        }
+    }
+
+    if (paths.size() != 2)
+    {
+        throw std::runtime_error("Usage: " + std::string(argv[0]) + " pack <input_file> <output.lpk> [--threads <n>]");
+    }
+    return pack_log(paths[0], paths[1], threads);
+}
+
+int search_pack(const ProgramOptions& options)
+{
+    if (options.patternsMode || !options.queryFilePath.empty() || !options.checkpointPath.empty() || options.estimateMode)
+    {
+        throw std::runtime_error("--patterns, --query-file, --checkpoint and --estimate are not supported for .lpk archives.");
+    }
+
+    MappedFile archive(options.inputFilePath);
+    TimestampLayout dateFormat {};
+    uint64_t originalSize {0};
+    std::vector<PackedBlock> blocks {read_index(archive.view(), dateFormat, originalSize)};
+
+    // Match destination (-o flag), stdout by default
+    std::ofstream outputFile;
+    std::ostream& out {open_output(options.outputFilePath, outputFile)};
+
+    // Same output as search_in_file() for an empty log
+    if (originalSize == 0)
+    {
+        if (options.outputFormat == OutputFormat::TEXT)
+        {
+            out << '\n' << "Total matches: 0" << std::endl;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Detected over the whole log at pack time, exactly as a text scan would
+    ProgramOptions packOptions {options};
+    packOptions.detectedDateFormat = dateFormat;
+    LineMatcher matcher(packOptions);
+
+    // Which blocks can contain a match
+    auto literals {matcher.required_literals()};
+    bool levelSkip {options.levelMask != ALL_LOG_LEVELS_MASK && options.logFormat == DEFAULT_LOG_LEVEL_CONFIG};
+    std::optional<int64_t> fromMs;
+    std::optional<int64_t> toMs;
+    if (options.fromTime)
+        fromMs = std::chrono::duration_cast<std::chrono::milliseconds>(options.fromTime->time_since_epoch()).count();
+    if (options.toTime)
+        toMs = std::chrono::duration_cast<std::chrono::milliseconds>(options.toTime->time_since_epoch()).count();
+
+    auto may_match = [&](const BlockMeta& meta) {
+        if (levelSkip && (meta.levelBitmap & options.levelMask) == 0)
+        {
+            return false;
+        }
+        if ((fromMs || toMs) && dateFormat.known() && !(meta.flags & (PACK_FLAG_UNDATED_LINES | PACK_FLAG_LOCAL_TIMES))
+            && ((fromMs && meta.maxTimestampMs < *fromMs) || (toMs && meta.minTimestampMs > *toMs)))
+        {
+            return false; // every line is dated outside the range
+        }
+        if (literals)
+        {
+            for (const auto& literal : *literals)
+            {
+                if (bloom_may_contain(meta, literal))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        return true;
+    };
+
+    // Context lines may reach into a neighbouring block (at most one, if every block is longer than the context)
+    int context {std::max(options.beforeContext, options.afterContext)};
+    bool canSkip {true};
+    for (const auto& block : blocks)
+    {
+        canSkip &= context < static_cast<int>(block.meta.lineCount);
+    }
+
+    std::vector<bool> selected(blocks.size(), !canSkip);
+    if (canSkip)
+    {
+        for (size_t b = 0; b < blocks.size(); ++b)
+        {
+            if (!may_match(blocks[b].meta))
+            {
+                continue;
+            }
+            selected[b] = true;
+            if (context > 0)
+            {
+                selected[b > 0 ? b - 1 : b] = true;
+                selected[std::min(b + 1, blocks.size() - 1)] = true;
+            }
+        }
+    }
+
+    std::vector<size_t> pending;
+    for (size_t b = 0; b < blocks.size(); ++b)
+    {
+        if (selected[b])
+        {
+            pending.push_back(b);
+        }
+    }
+
+    struct DecodedBlock
+    {
+        std::string text;
+        uint32_t lineCount {0};
+        LogSegment segment;
+    };
+
+    // Decompressed in parallel batches; earlier blocks stay alive while before-context may point into them
+    size_t workerCount {resolve_thread_count(options.threads)};
+    size_t nextPending {0};
+    std::deque<DecodedBlock> ready;
+    std::deque<DecodedBlock> retained;
+
+    auto nextSegment = [&]() -> const LogSegment* {
+        if (ready.empty() && nextPending < pending.size())
+        {
+            size_t batchSize {std::min(workerCount, pending.size() - nextPending)};
+            std::vector<std::string> texts(batchSize);
+            run_parallel(batchSize, workerCount, [&](size_t i) {
+                texts[i] = decompress_block(blocks[pending[nextPending + i]]);
+            });
+
+            for (size_t i = 0; i < batchSize; ++i)
+            {
+                const PackedBlock& block {blocks[pending[nextPending + i]]};
+                ready.push_back({std::move(texts[i]), block.meta.lineCount, {}});
+                ready.back().segment = {ready.back().text, block.firstLineNumber, block.originalOffset, true};
+            }
+            nextPending += batchSize;
+        }
+
+        if (ready.empty())
+        {
+            return nullptr;
+        }
+
+        retained.push_back(std::move(ready.front()));
+        ready.pop_front();
+        retained.back().segment.data = retained.back().text; // text buffer moved with the block
+
+        // Drop the oldest block once the blocks after it hold the last -B lines before the current one
+        int linesBefore {0};
+        for (size_t i = 1; i + 1 < retained.size(); ++i)
+        {
+            linesBefore += static_cast<int>(retained[i].lineCount);
+        }
+        while (retained.size() > 1 && linesBefore >= options.beforeContext)
+        {
+            retained.pop_front();
+            linesBefore -= retained.size() > 1 ? static_cast<int>(retained.front().lineCount) : 0;
+        }
+        return &retained.back().segment;
+    };
+
+    search_segments(nextSegment, packOptions, matcher, out, std::cerr);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+// src/pack.h
+
+#ifndef PACK_H
+#define PACK_H
+
+#include "arg_parser.h"
+#include <cstdint>
+#include <string>
+
+/*
+ * .lpk archive: a log stored as independently xz-compressed blocks of whole lines,
+ * each with metadata that lets a search skip it without decompressing.
+ * All integers are little endian.
+ *
+ *   File header:
+ *     char[4] magic "\x89LPK"  u32 version
+ *     u32 target block size    u8  timestamp layout (LogDateFormat)  u8 reserved  u16 timestamp column
+ *     u64 original size        u64 block count
+ *   Per block:
+ *     u64 compressed size      u64 uncompressed size
+ *     u32 line count           u8  level bitmap (log_level_bit, GENERIC keywords)
+ *     u8  flags (PACK_FLAG_*)  u16 reserved
+ *     i64 min timestamp (epoch ms)            i64 max timestamp (epoch ms)
+ *     u8[PACK_BLOOM_BYTES] bloom filter of the case-folded byte trigrams
+ *     compressed payload (xz stream)
+ */
+
+constexpr char PACK_MAGIC[4] {'\x89', 'L', 'P', 'K'}; // 0x89 is not text: a log never starts with it
+constexpr uint32_t PACK_VERSION {3}; // 2: timestamp column, millisecond timestamps; 3: PACK_FLAG_LOCAL_TIMES
+constexpr size_t PACK_FILE_HEADER_SIZE {32};
+constexpr size_t PACK_BLOCK_SIZE {4 * 1024 * 1024};     // uncompressed bytes per block (cut at a newline)
+constexpr size_t PACK_BLOOM_BYTES {8 * 1024};
+constexpr size_t PACK_BLOOM_HASHES {3};
+constexpr size_t PACK_BLOCK_HEADER_SIZE {40 + PACK_BLOOM_BYTES};
+constexpr uint32_t PACK_COMPRESSION_PRESET {6};
+constexpr uint8_t PACK_FLAG_UNDATED_LINES {1};         // block has lines without a timestamp
+constexpr uint8_t PACK_FLAG_LOCAL_TIMES {2};           // block has zone-less or syslog (yearless) timestamps
+
+/**
+ * Checks whether a file is an .lpk archive this build can read: the magic,
+ * PACK_VERSION and a complete file header. Anything else is searched as text.
+ *
+ * @param path File to check.
+ * @return true if the file starts with a readable .lpk header.
+ */
+bool is_pack_file(const std::string& path);
+
+/**
+ * Writes a log file as an .lpk archive (`logparser pack`). Blocks are
+ * analyzed and compressed in parallel and written in order.
+ *
+ * @param inputPath Plain text log file.
+ * @param outputPath Archive to create (overwritten).
+ * @param threads Worker threads (0 = one per hardware thread).
+ * @return EXIT_SUCCESS on completion.
+ * @throws std::runtime_error on file or compression errors.
+ */
+int pack_log(const std::string& inputPath, const std::string& outputPath, int threads);
+
+/**
+ * Entry point for the `pack` subcommand:
+ *
+ *   logparser pack <input_file> <output.lpk> [--threads <n>]
+ *
+ * @param argc Argument count from main() (argv[1] is the subcommand).
+ * @param argv Argument vector from main().
+ * @return Process exit code.
+ */
+int run_pack_command(int argc, char* argv[]);
+
+/**
+ * Searches an .lpk archive with the output of a search over the original text.
+ *
+ * Blocks are skipped when their metadata rules out a match: no required literal
+ * of the query can be present (trigram bloom filter), no line has a level of
+ * the --level filter, or every line is dated outside -from/-to. Surviving
+ * blocks are decompressed in parallel batches and scanned in order, so line
+ * numbers, offsets and context lines are the same as for the text file. With
+ * context lines, the neighbours of a surviving block are decompressed as well.
+ *
+ * @param options Parsed program options (inputFilePath is the archive).
+ * @return EXIT_SUCCESS on completion.
+ * @throws std::runtime_error on malformed archives or unsupported modes.
+ */
+int search_pack(const ProgramOptions& options);
+
+#endif // PACK_H
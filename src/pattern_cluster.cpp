@@ -0,0 +1,408 @@
+// src/pattern_cluster.cpp
+
+#include "pattern_cluster.h"
+#include "mapped_file.h"
+#include "matcher.h"
+#include "utils.h"
+#include "date.h"
+#include "file_processor.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    constexpr size_t UUID_LENGTH {36};
+    constexpr size_t MIN_BARE_HEX_LENGTH {8}; // shorter hex-looking words are usually real words
+
+    inline bool is_digit(char c) { return c >= '0' && c <= '9'; }
+    inline bool is_alpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    inline bool is_alnum(char c) { return is_digit(c) || is_alpha(c); }
+    inline bool is_hex(char c) { return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+
+    inline bool ends_token(std::string_view s, size_t pos)
+    {
+        return pos >= s.size() || !is_alnum(s[pos]);
+    }
+
+    // 8-4-4-4-12 hex groups
+    size_t match_uuid(std::string_view s, size_t pos)
+    {
+        if (pos + UUID_LENGTH > s.size())
+            return 0;
+
+        for (size_t k = 0; k < UUID_LENGTH; ++k)
+        {
+            char c {s[pos + k]};
+            bool dash {k == 8 || k == 13 || k == 18 || k == 23};
+            if (dash ? c != '-' : !is_hex(c))
+                return 0;
+        }
+        return ends_token(s, pos + UUID_LENGTH) ? UUID_LENGTH : 0;
+    }
+
+    // a.b.c.d with optional :port
+    size_t match_ipv4(std::string_view s, size_t pos)
+    {
+        size_t i {pos};
+        for (int group = 0; group < 4; ++group)
+        {
+            size_t digits {0};
+            while (i < s.size() && is_digit(s[i]) && digits < 4)
+            {
+                ++i;
+                ++digits;
+            }
+            if (digits == 0 || digits > 3)
+                return 0;
+            if (group < 3)
+            {
+                if (i >= s.size() || s[i] != '.')
+                    return 0;
+                ++i;
+            }
+        }
+
+        if (!ends_token(s, i) || (i + 1 < s.size() && s[i] == '.' && is_digit(s[i + 1])))
+            return 0;
+
+        if (i + 1 < s.size() && s[i] == ':' && is_digit(s[i + 1]))
+        {
+            ++i;
+            while (i < s.size() && is_digit(s[i]))
+                ++i;
+        }
+        return i - pos;
+    }
+
+    // 0x1f2e... or a bare hex id (>= 8 chars, at least one digit)
+    size_t match_hex(std::string_view s, size_t pos)
+    {
+        size_t i {pos};
+        if (i + 2 < s.size() && s[i] == '0' && (s[i + 1] == 'x' || s[i + 1] == 'X') && is_hex(s[i + 2]))
+        {
+            i += 2;
+            while (i < s.size() && is_hex(s[i]))
+                ++i;
+            return ends_token(s, i) ? i - pos : 0;
+        }
+
+        bool hasDigit {false};
+        bool hasLetter {false};
+        while (i < s.size() && is_hex(s[i]))
+        {
+            hasDigit |= is_digit(s[i]);
+            hasLetter |= is_alpha(s[i]);
+            ++i;
+        }
+        size_t length {i - pos};
+        return (length >= MIN_BARE_HEX_LENGTH && hasDigit && hasLetter && ends_token(s, i)) ? length : 0;
+    }
+
+    // Same filters as a search: pattern, --level, -from/-to (lines without a timestamp are kept)
+    void scan_slice(std::string_view slice, const ProgramOptions& options, const LineMatcher& matcher,
+                    const TimestampLayout& layout, TemplateTable& table)
+    {
+        bool levelFilter {options.levelMask != ALL_LOG_LEVELS_MASK};
+        bool dateFilter {options.fromTime.has_value() || options.toTime.has_value()};
+
+        std::string templ;
+        templ.reserve(TEMPLATE_BUFFER_RESERVE);
+
+        const char* lineStart {slice.data()};
+        const char* sliceEnd {slice.data() + slice.size()};
+
+        while (lineStart < sliceEnd)
+        {
+            const char* lineEnd {static_cast<const char*>(memchr(lineStart, '\n', sliceEnd - lineStart))};
+            if (lineEnd == nullptr)
+            {
+                lineEnd = sliceEnd;
+            }
+
+            size_t lineLength {static_cast<size_t>(lineEnd - lineStart)};
+            if (lineLength > 0 && lineStart[lineLength - 1] == '\r')
+            {
+                --lineLength;
+            }
+
+            std::string_view lineView(lineStart, lineLength);
+            lineStart = lineEnd + (lineEnd < sliceEnd ? 1 : 0);
+
+            if (!matcher.matches(lineView)
+                || (levelFilter && !level_in_mask(detect_log_level(lineView, options.logFormat), options.levelMask)))
+            {
+                continue;
+            }
+
+            auto ts {find_timestamp(lineView, layout)};
+            if (dateFilter && ts
+                && ((options.fromTime && ts->time < *options.fromTime) || (options.toTime && ts->time > *options.toTime)))
+            {
+                continue;
+            }
+
+            normalize_template(lineView, ts, templ);
+            table.add(templ, lineView);
+        }
+    }
+
+    // Timestamp text of a line as written in the log, without nginx-style brackets
+    std::string_view timestamp_of(std::string_view line, const TimestampLayout& layout)
+    {
+        auto ts {find_timestamp(line, layout)};
+        if (!ts)
+        {
+            return "-";
+        }
+
+        std::string_view text {line.substr(ts->begin, ts->end - ts->begin)};
+        if (text.size() >= 2 && text.front() == '[' && text.back() == ']')
+        {
+            text = text.substr(1, text.size() - 2);
+        }
+        return text;
+    }
+}
+
+TemplateTable::TemplateTable(size_t initialCapacity)
+    : m_slots(std::bit_ceil(std::max<size_t>(initialCapacity, 16)))
+{
+}
+
+void TemplateTable::add(std::string_view templ, std::string_view line)
+{
+    TemplateEntry& entry {find_or_insert(fnv1a_hash(templ), templ)};
+
+    if (entry.count == 0)
+    {
+        entry.firstLine = line;
+    }
+    entry.lastLine = line;
+    ++entry.count;
+    ++m_totalLines;
+}
+
+void TemplateTable::merge(const TemplateTable& other)
+{
+    for (const auto& theirs : other.m_slots)
+    {
+        if (theirs.count == 0)
+            continue;
+
+        TemplateEntry& ours {find_or_insert(theirs.hash, theirs.text)};
+
+        // Both tables point into the same mapping, so pointer order == file order
+        if (ours.count == 0 || theirs.firstLine.data() < ours.firstLine.data())
+            ours.firstLine = theirs.firstLine;
+        if (ours.count == 0 || theirs.lastLine.data() > ours.lastLine.data())
+            ours.lastLine = theirs.lastLine;
+        ours.count += theirs.count;
+    }
+    m_totalLines += other.m_totalLines;
+}
+
+std::vector<const TemplateEntry*> TemplateTable::top(size_t k) const
+{
+    std::vector<const TemplateEntry*> entries;
+    entries.reserve(m_size);
+    for (const auto& entry : m_slots)
+    {
+        if (entry.count > 0)
+            entries.push_back(&entry);
+    }
+
+    k = std::min(k, entries.size());
+    std::partial_sort(entries.begin(), entries.begin() + k, entries.end(),
+                      [](const TemplateEntry* a, const TemplateEntry* b) {
+                          if (a->count != b->count) return a->count > b->count;
+                          return a->firstLine.data() < b->firstLine.data();
+                      });
+    entries.resize(k);
+    return entries;
+}
+
+TemplateEntry& TemplateTable::find_or_insert(uint64_t hash, std::string_view templ)
+{
+    // Keep load factor <= 0.5 so probe sequences stay short
+    if ((m_size + 1) * 2 > m_slots.size())
+    {
+        grow();
+    }
+
+    size_t mask {m_slots.size() - 1};
+    size_t index {static_cast<size_t>(hash) & mask};
+
+    while (true)
+    {
+        TemplateEntry& slot {m_slots[index]};
+        if (slot.count == 0)
+        {
+            slot.hash = hash;
+            slot.text = m_arena.store(templ);
+            ++m_size;
+            return slot;
+        }
+        if (slot.hash == hash && slot.text == templ)
+        {
+            return slot;
+        }
+        index = (index + 1) & mask;
+    }
+}
+
+void TemplateTable::grow()
+{
+    std::vector<TemplateEntry> old(m_slots.size() * 2);
+    old.swap(m_slots);
+
+    size_t mask {m_slots.size() - 1};
+    for (const auto& entry : old)
+    {
+        if (entry.count == 0)
+            continue;
+
+        size_t index {static_cast<size_t>(entry.hash) & mask};
+        while (m_slots[index].count != 0)
+        {
+            index = (index + 1) & mask;
+        }
+        m_slots[index] = entry; // text stays in the arena, no copy
+    }
+}
+
+void normalize_template(std::string_view line, const std::optional<TimestampMatch>& ts, std::string& out)
+{
+    out.clear();
+
+    // A leading timestamp is dropped with the blanks after it, one inside the line becomes <TS>
+    size_t i {0};
+    size_t tsBegin {std::string_view::npos};
+    size_t tsEnd {0};
+    if (ts)
+    {
+        tsBegin = ts->begin;
+        tsEnd = ts->end;
+        if (tsBegin == 0)
+        {
+            while (tsEnd < line.size() && line[tsEnd] == ' ')
+                ++tsEnd;
+            i = tsEnd;
+        }
+    }
+
+    while (i < line.size())
+    {
+        if (i == tsBegin)
+        {
+            out += "<TS>";
+            i = tsEnd;
+            continue;
+        }
+
+        char c {line[i]};
+        bool wordStart {i == 0 || !is_alnum(line[i - 1])};
+
+        if (wordStart && is_hex(c))
+        {
+            if (size_t length = match_uuid(line, i))
+            {
+                out += "<UUID>";
+                i += length;
+                continue;
+            }
+            if (size_t length = match_ipv4(line, i))
+            {
+                out += "<IP>";
+                i += length;
+                continue;
+            }
+            if (size_t length = match_hex(line, i))
+            {
+                out += "<HEX>";
+                i += length;
+                continue;
+            }
+        }
+
+        if (is_digit(c))
+        {
+            // digit run with optional decimal parts (1.5, 10.0.3)
+            while (i < line.size() && is_digit(line[i]))
+            {
+                ++i;
+                if (i + 1 < line.size() && line[i] == '.' && is_digit(line[i + 1]))
+                    ++i;
+            }
+            out += "<NUM>";
+            continue;
+        }
+
+        out += c;
+        ++i;
+    }
+}
+
+int cluster_patterns(const ProgramOptions& options)
+{
+    MappedFile file(options.inputFilePath);
+    LineMatcher matcher(options);
+    TimestampLayout layout {detect_timestamp_layout(file.view())};
+
+    size_t threadCount {resolve_thread_count(options.threads)};
+    threadCount = std::max<size_t>(1, std::min<size_t>(threadCount, file.size() / PARALLEL_CHUNK_MIN_SIZE));
+
+    std::vector<std::string_view> slices {split_line_aligned(file.view(), threadCount)};
+    std::vector<TemplateTable> tables(std::max<size_t>(slices.size(), 1));
+
+    if (slices.size() > 1)
+    {
+        std::vector<std::thread> workers;
+        workers.reserve(slices.size());
+        for (size_t t = 0; t < slices.size(); ++t)
+        {
+            workers.emplace_back(scan_slice, slices[t], std::cref(options), std::cref(matcher), std::cref(layout),
+                                     std::ref(tables[t]));
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        for (size_t t = 1; t < tables.size(); ++t)
+        {
+            tables[0].merge(tables[t]);
+        }
+    }
+    else if (!slices.empty())
+    {
+        scan_slice(slices[0], options, matcher, layout, tables[0]);
+    }
+
+    const TemplateTable& table {tables[0]};
+    auto entries {table.top(static_cast<size_t>(options.topPatterns))};
+
+    std::ofstream outputFile;
+    std::ostream& out {open_output(options.outputFilePath, outputFile)};
+
+    int rank {0};
+    for (const TemplateEntry* entry : entries)
+    {
+        double share {100.0 * static_cast<double>(entry->count) / static_cast<double>(table.total_lines())};
+        auto color = get_log_level_color(detect_log_level(entry->firstLine, options.logFormat));
+
+        out << color << "[#" << ++rank << "] " << entry->count << " lines ("
+                  << std::fixed << std::setprecision(2) << share << "%)"
+                  << "  first: " << timestamp_of(entry->firstLine, layout)
+                  << "  last: " << timestamp_of(entry->lastLine, layout) << RESET_COLOR << '\n';
+        out << "    " << entry->text << '\n';
+        out << "    e.g. " << entry->firstLine << "\n\n";
+    }
+
+    out << "Total Templates: " << table.size() << '\n';
+    out << "Total Lines: " << table.total_lines() << std::endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,104 @@
+// src/pattern_cluster.h
+
+#ifndef PATTERN_CLUSTER_H
+#define PATTERN_CLUSTER_H
+
+#include "arg_parser.h"
+#include "arena.h"
+#include "date.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+constexpr size_t TEMPLATE_TABLE_INITIAL_CAPACITY {1024}; // must be a power of two
+constexpr size_t TEMPLATE_BUFFER_RESERVE {512};          // per-thread normalization buffer
+constexpr off_t PARALLEL_CHUNK_MIN_SIZE {4 * 1024 * 1024}; // don't spawn threads for tiny slices
+
+/**
+ * One message template (--patterns mode) with its statistics.
+ * Template text lives in the owning table's arena, first/last lines point into the mapped file.
+ */
+struct TemplateEntry
+{
+    uint64_t hash {0};
+    std::string_view text;      // normalized template (arena-owned)
+    uint64_t count {0};         // 0 = empty slot
+    std::string_view firstLine; // earliest occurrence in file order (also used as example)
+    std::string_view lastLine;  // latest occurrence in file order
+};
+
+/**
+ * Open-addressing hash table (linear probing) of message templates.
+ * Keys are copied into an arena on first insert, so steady-state add() calls
+ * never touch the heap. Tables built by different threads over different
+ * slices of the same mapping can be merged afterwards.
+ */
+class TemplateTable
+{
+public:
+    explicit TemplateTable(size_t initialCapacity = TEMPLATE_TABLE_INITIAL_CAPACITY);
+
+    /**
+     * Counts one occurrence of a template.
+     *
+     * @param templ Normalized template text (copied into the arena if new).
+     * @param line Original line (must point into the mapped file).
+     */
+    void add(std::string_view templ, std::string_view line);
+
+    /**
+     * Folds another table into this one (counts summed, first/last by file position).
+     *
+     * @param other Table built over a slice of the same mapping.
+     */
+    void merge(const TemplateTable& other);
+
+    /**
+     * Returns the K most frequent templates, most frequent first.
+     * Pointers stay valid until the table is modified.
+     *
+     * @param k Maximum number of entries to return.
+     */
+    std::vector<const TemplateEntry*> top(size_t k) const;
+
+    size_t size() const { return m_size; }
+    uint64_t total_lines() const { return m_totalLines; }
+
+private:
+    TemplateEntry& find_or_insert(uint64_t hash, std::string_view templ);
+    void grow();
+
+    std::vector<TemplateEntry> m_slots;
+    size_t m_size {0};
+    uint64_t m_totalLines {0};
+    Arena m_arena;
+};
+
+/**
+ * Replaces variable tokens of a log line with placeholders:
+ * UUIDs -> <UUID>, IPv4 (with optional port) -> <IP>, 0x.. / long hex ids -> <HEX>,
+ * digit runs (incl. decimals) -> <NUM>, the timestamp -> <TS> (dropped if it starts the line).
+ *
+ * @param line Raw log line.
+ * @param ts Timestamp of the line (see find_timestamp()), std::nullopt if it has none.
+ * @param out Reused output buffer (cleared first, capacity kept between calls).
+ */
+void normalize_template(std::string_view line, const std::optional<TimestampMatch>& ts, std::string& out);
+
+/**
+ * --patterns mode: clusters all (matching) lines by message template in one
+ * streaming pass over the mapped file and prints the top-K templates with
+ * counts, first/last timestamps and an example line.
+ * Large files are split into newline-aligned slices scanned by worker threads,
+ * whose tables are merged at the end.
+ *
+ * @param options Parsed program options (search patterns, --level and -from/-to filter
+ *                the lines, -o redirects the report).
+ * @return EXIT_SUCCESS on completion.
+ * @throws std::runtime_error on file or memory mapping errors.
+ */
+int cluster_patterns(const ProgramOptions& options);
+
+#endif // PATTERN_CLUSTER_H
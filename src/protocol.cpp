@@ -0,0 +1,255 @@
+// src/protocol.cpp
+
+#include "protocol.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+    void write_all(int fd, const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            ssize_t written {send(fd, data, size, MSG_NOSIGNAL)};
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("Socket write failed: " + std::string(strerror(errno)));
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+    // Returns bytes read (< size only at end of stream)
+    size_t read_all(int fd, char* data, size_t size)
+    {
+        size_t total {0};
+        while (total < size)
+        {
+            ssize_t received {recv(fd, data + total, size - total, 0)};
+            if (received < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw std::runtime_error("Socket read failed: " + std::string(strerror(errno)));
+            }
+            if (received == 0)
+                break;
+            total += static_cast<size_t>(received);
+        }
+        return total;
+    }
+
+    sockaddr_un make_address(const std::string& path)
+    {
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path))
+        {
+            throw std::runtime_error("Socket path too long: " + path);
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    // Removes the socket file of a daemon that is gone; a live daemon or any other file is left alone
+    void remove_stale_socket(const std::string& path, const sockaddr_un& address)
+    {
+        struct stat info;
+        if (lstat(path.c_str(), &info) == -1)
+        {
+            return; // nothing there
+        }
+        if (!S_ISSOCK(info.st_mode))
+        {
+            throw std::runtime_error("Failed to listen on " + path + ": file exists and is not a socket");
+        }
+
+        int probe {socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+        if (probe == -1)
+        {
+            throw std::runtime_error("Failed to create socket");
+        }
+        int connected {connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address))};
+        int error {errno};
+        close(probe);
+
+        if (connected == 0)
+        {
+            throw std::runtime_error("Failed to listen on " + path + ": daemon already running");
+        }
+        if (error != ECONNREFUSED)
+        {
+            throw std::runtime_error("Failed to listen on " + path + ": " + strerror(error));
+        }
+        unlink(path.c_str());
+    }
+}
+
+void write_frame(int fd, FrameType type, std::string_view payload)
+{
+    if (payload.size() > MAX_FRAME_PAYLOAD)
+    {
+        throw std::runtime_error("Frame payload too large");
+    }
+
+    uint32_t length {static_cast<uint32_t>(payload.size())};
+    char header[FRAME_HEADER_SIZE] {
+        static_cast<char>(length & 0xFF),
+        static_cast<char>((length >> 8) & 0xFF),
+        static_cast<char>((length >> 16) & 0xFF),
+        static_cast<char>((length >> 24) & 0xFF),
+        static_cast<char>(type)
+    };
+
+    write_all(fd, header, FRAME_HEADER_SIZE);
+    write_all(fd, payload.data(), payload.size());
+}
+
+bool read_frame(int fd, FrameType& type, std::string& payload)
+{
+    unsigned char header[FRAME_HEADER_SIZE];
+    size_t received {read_all(fd, reinterpret_cast<char*>(header), FRAME_HEADER_SIZE)};
+    if (received == 0)
+    {
+        return false;
+    }
+    if (received < FRAME_HEADER_SIZE)
+    {
+        throw std::runtime_error("Truncated frame header");
+    }
+
+    uint32_t length {header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<uint32_t>(header[3]) << 24)};
+    if (length > MAX_FRAME_PAYLOAD)
+    {
+        throw std::runtime_error("Frame payload too large");
+    }
+
+    type = static_cast<FrameType>(header[4]);
+    payload.resize(length);
+    if (read_all(fd, payload.data(), length) != length)
+    {
+        throw std::runtime_error("Truncated frame payload");
+    }
+    return true;
+}
+
+std::string encode_arguments(const std::vector<std::string>& args)
+{
+    std::string payload;
+    for (const auto& arg : args)
+    {
+        payload += arg;
+        payload += '\0';
+    }
+    return payload;
+}
+
+std::vector<std::string> decode_arguments(std::string_view payload)
+{
+    std::vector<std::string> args;
+    size_t start {0};
+    while (start < payload.size())
+    {
+        size_t end {payload.find('\0', start)};
+        if (end == std::string_view::npos)
+            end = payload.size();
+        args.emplace_back(payload.substr(start, end - start));
+        start = end + 1;
+    }
+    return args;
+}
+
+int listen_unix_socket(const std::string& path)
+{
+    sockaddr_un address {make_address(path)};
+    remove_stale_socket(path, address);
+
+    int fd {socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (fd == -1)
+    {
+        throw std::runtime_error("Failed to create socket");
+    }
+
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1
+        || listen(fd, SOMAXCONN) == -1)
+    {
+        int error {errno};
+        close(fd);
+        throw std::runtime_error("Failed to listen on " + path + ": " + strerror(error));
+    }
+    return fd;
+}
+
+int connect_unix_socket(const std::string& path)
+{
+    sockaddr_un address {make_address(path)};
+
+    int fd {socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)};
+    if (fd == -1)
+    {
+        throw std::runtime_error("Failed to create socket");
+    }
+
+    if (connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1)
+    {
+        int error {errno};
+        close(fd);
+        throw std::runtime_error("Failed to connect to " + path + ": " + strerror(error));
+    }
+    return fd;
+}
+
+FrameStreamBuf::FrameStreamBuf(int fd, FrameType type)
+    : m_fd {fd},
+      m_type {type},
+      m_buffer(STREAM_FRAME_SIZE)
+{
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
+
+FrameStreamBuf::~FrameStreamBuf()
+{
+    try
+    {
+        send_buffered();
+    }
+    catch (const std::exception&)
+    {
+        // peer already gone, nothing left to report to
+    }
+}
+
+FrameStreamBuf::int_type FrameStreamBuf::overflow(int_type ch)
+{
+    send_buffered();
+    if (!traits_type::eq_int_type(ch, traits_type::eof()))
+    {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+int FrameStreamBuf::sync()
+{
+    send_buffered();
+    return 0;
+}
+
+void FrameStreamBuf::send_buffered()
+{
+    size_t pending {static_cast<size_t>(pptr() - pbase())};
+    if (pending > 0)
+    {
+        write_frame(m_fd, m_type, std::string_view(pbase(), pending));
+    }
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+}
@@ -0,0 +1,99 @@
+// src/protocol.h
+
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <cstdint>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*
+ * Framed protocol between `logparser query` and `logparser serve` (Unix stream socket).
+ *
+ * Every frame: [u32 payload length, little endian][u8 frame type][payload]
+ *
+ *   client -> server: REQUEST (command-line arguments, '\0' separated)
+ *   server -> client: STDOUT* / STDERR* (streamed while the scan runs), then EXIT (exit code byte)
+ *
+ * One request per connection.
+ */
+
+enum class FrameType : uint8_t
+{
+    REQUEST = 1,
+    STDOUT = 2,
+    STDERR = 3,
+    EXIT = 4
+};
+
+constexpr size_t FRAME_HEADER_SIZE {5};
+constexpr uint32_t MAX_FRAME_PAYLOAD {16 * 1024 * 1024};
+constexpr size_t STREAM_FRAME_SIZE {64 * 1024}; // output is sent in chunks of this size
+constexpr const char* DEFAULT_SOCKET_PATH = "/tmp/logparser.sock";
+
+/**
+ * Writes one frame (blocking, no SIGPIPE).
+ *
+ * @throws std::runtime_error if the peer is gone or the payload is too large.
+ */
+void write_frame(int fd, FrameType type, std::string_view payload);
+
+/**
+ * Reads one frame (blocking).
+ *
+ * @param type Receives the frame type.
+ * @param payload Receives the payload (reused buffer).
+ * @return false on a clean end of stream before the header.
+ * @throws std::runtime_error on truncated or oversized frames.
+ */
+bool read_frame(int fd, FrameType& type, std::string& payload);
+
+/**
+ * Packs arguments for a REQUEST frame ('\0' separated) and back.
+ */
+std::string encode_arguments(const std::vector<std::string>& args);
+std::vector<std::string> decode_arguments(std::string_view payload);
+
+/**
+ * Creates, binds and listens on a Unix socket. A socket file left by a daemon
+ * that is gone (connect() refused) is replaced; a live daemon's socket or any
+ * other file at the path is an error.
+ *
+ * @throws std::runtime_error on socket errors, if a daemon already listens there
+ *         or if the path is not a socket.
+ */
+int listen_unix_socket(const std::string& path);
+
+/**
+ * Connects to a Unix socket.
+ *
+ * @throws std::runtime_error if no server is listening.
+ */
+int connect_unix_socket(const std::string& path);
+
+/**
+ * std::streambuf that sends everything written to it as frames of one type,
+ * so an std::ostream (e.g. a MatchWriter destination) streams over the socket.
+ * Data is sent whenever STREAM_FRAME_SIZE bytes are buffered and on flush.
+ */
+class FrameStreamBuf : public std::streambuf
+{
+public:
+    FrameStreamBuf(int fd, FrameType type);
+    ~FrameStreamBuf() override;
+
+protected:
+    int_type overflow(int_type ch) override;
+    int sync() override;
+
+private:
+    void send_buffered();
+
+    int m_fd;
+    FrameType m_type;
+    std::vector<char> m_buffer;
+};
+
+#endif // PROTOCOL_H
@@ -0,0 +1,332 @@
+// src/query_batch.cpp
+
+#include "query_batch.h"
+#include "file_processor.h"
+#include "multi_pattern.h"
+#include <filesystem>
+#include <map>
+#include <memory>
+
+namespace
+{
+    struct BatchQuery
+    {
+        ProgramOptions options;
+        LineMatcher matcher;
+        std::ofstream outputFile;               // owns the -o destination (if any)
+        std::unique_ptr<MatchWriter> writer;
+        bool alwaysCandidate {false};           // no literal to prefilter on
+        bool hasDateFilter {false};
+
+        explicit BatchQuery(ProgramOptions opts)
+            : options {std::move(opts)},
+              matcher {options}
+        {
+            std::ostream& out {open_output(options.outputFilePath, outputFile)};
+            writer = std::make_unique<MatchWriter>(out, options.beforeContext, options.afterContext, options.outputFormat, matcher);
+            hasDateFilter = options.fromTime.has_value() || options.toTime.has_value();
+        }
+    };
+
+    std::vector<std::unique_ptr<BatchQuery>> load_queries(const ProgramOptions& options)
+    {
+        std::ifstream queryFile(options.queryFilePath);
+        if (!queryFile)
+        {
+            throw std::runtime_error("Failed to open query file: " + options.queryFilePath);
+        }
+
+        std::vector<std::unique_ptr<BatchQuery>> queries;
+        std::map<std::filesystem::path, size_t> outputOwners; // -o file -> query number (opening truncates)
+        std::string line;
+        int lineNumber {0};
+
+        while (std::getline(queryFile, line))
+        {
+            ++lineNumber;
+
+            try
+            {
+                std::vector<std::string> tokens {split_query_line(line)};
+                if (tokens.empty() || tokens.front().starts_with('#'))
+                {
+                    continue;
+                }
+
+                // Reuse the command-line parser: argv = {program, input file, tokens...}
+                std::vector<std::string> args {"logparser", options.inputFilePath};
+                args.insert(args.end(), tokens.begin(), tokens.end());
+                std::vector<char*> argv;
+                for (auto& arg : args)
+                {
+                    argv.push_back(arg.data());
+                }
+
+                ProgramOptions queryOptions {parse_arguments(static_cast<int>(argv.size()), argv.data())};
+                if (queryOptions.patternsMode || queryOptions.estimateMode || !queryOptions.queryFilePath.empty()
+                    || !queryOptions.checkpointPath.empty())
+                {
+                    throw std::runtime_error("--patterns/--query-file/--checkpoint/--estimate are not allowed inside a query file.");
+                }
+                if (queryOptions.outputFormat != OutputFormat::TEXT && queryOptions.outputFilePath.empty())
+                {
+                    throw std::runtime_error("--output jsonl/binary inside a query file requires -o (stdout is shared).");
+                }
+                if (!queryOptions.outputFilePath.empty())
+                {
+                    auto [owner, inserted] = outputOwners.try_emplace(
+                        std::filesystem::weakly_canonical(queryOptions.outputFilePath), queries.size() + 1);
+                    if (!inserted)
+                    {
+                        throw std::runtime_error("-o " + queryOptions.outputFilePath + " is already the output of query "
+                                                 + std::to_string(owner->second) + ".");
+                    }
+                }
+                queries.push_back(std::make_unique<BatchQuery>(std::move(queryOptions)));
+            }
+
+            catch (const std::exception& ex)
+            {
+                throw std::runtime_error(options.queryFilePath + ":" + std::to_string(lineNumber) + ": " + ex.what());
+            }
+        }
+
+        if (queries.empty())
+        {
+            throw std::runtime_error("Query file contains no queries: " + options.queryFilePath);
+        }
+
+        // Queries sharing stdout label their lines, or they could not be told apart
+        size_t stdoutQueries {0};
+        for (const auto& query : queries)
+        {
+            stdoutQueries += query->options.outputFilePath.empty();
+        }
+        for (size_t q = 0; q < queries.size() && stdoutQueries > 1; ++q)
+        {
+            if (queries[q]->options.outputFilePath.empty())
+            {
+                queries[q]->writer->set_label("[Q" + std::to_string(q + 1) + "] ");
+            }
+        }
+        return queries;
+    }
+}
+
+std::vector<std::string> split_query_line(const std::string& line)
+{
+    std::vector<std::string> tokens;
+    std::string current;
+    bool inToken {false};
+    size_t i {0};
+
+    while (i < line.size())
+    {
+        char c {line[i]};
+
+        if (c == '"' || c == '\'')
+        {
+            size_t close {i + 1};
+            while (close < line.size() && line[close] != c)
+            {
+                if (c == '"' && line[close] == '\\' && close + 1 < line.size()
+                    && (line[close + 1] == '"' || line[close + 1] == '\\'))
+                {
+                    ++close; // keep the escaped char, drop the backslash
+                }
+                current += line[close];
+                ++close;
+            }
+
+            if (close >= line.size())
+            {
+                throw std::runtime_error("Unterminated quote in query: " + line);
+            }
+            inToken = true;
+            i = close + 1;
+        }
+
+        else if (c == ' ' || c == '\t' || c == '\r')
+        {
+            if (inToken)
+            {
+                tokens.push_back(std::move(current));
+                current.clear();
+                inToken = false;
+            }
+            ++i;
+        }
+
+        else
+        {
+            current += c;
+            inToken = true;
+            ++i;
+        }
+    }
+
+    if (inToken)
+    {
+        tokens.push_back(std::move(current));
+    }
+    return tokens;
+}
+
+int run_query_file(const ProgramOptions& options)
+{
+    auto queries {load_queries(options)};
+    MappedFile file(options.inputFilePath);
+
+    // Shared prefilter: every literal of every query, case-folded (superset of all queries)
+    std::vector<std::string> literals;
+    std::vector<uint32_t> literalOwner; // literal index -> query index
+    bool anyDateFilter {false};
+
+    for (uint32_t q = 0; q < queries.size(); ++q)
+    {
+        auto required {queries[q]->matcher.required_literals()};
+        if (!required)
+        {
+            queries[q]->alwaysCandidate = true;
+        }
+        else
+        {
+            for (auto& literal : *required)
+            {
+                literals.push_back(std::move(literal));
+                literalOwner.push_back(q);
+            }
+        }
+        anyDateFilter |= queries[q]->hasDateFilter;
+    }
+
+    MultiPatternMatcher prefilter(literals, true);
+
+    // Timestamp layout detected once from the first lines (date filters and --output records)
+    TimestampLayout dateFormat {};
+    bool anyStructured {false};
+    for (const auto& query : queries)
+    {
+        anyStructured |= query->writer->structured();
+    }
+    if (anyDateFilter || anyStructured)
+    {
+        dateFormat = detect_timestamp_layout(file.view());
+    }
+    for (const auto& query : queries)
+    {
+        query->writer->set_source(file.view(), 0, dateFormat);
+    }
+
+    // candidateEpoch[q] == lineNumber <=> query q had a literal hit on this line
+    std::vector<int> candidateEpoch(queries.size(), 0);
+
+    int lineNumber {0};
+    int linesWithTimestamps {0};
+
+    const char* lineStart {file.data()};
+    const char* fileEnd {file.data() + file.size()};
+
+    while (lineStart < fileEnd)
+    {
+        const char* lineEnd {static_cast<const char*>(memchr(lineStart, '\n', fileEnd - lineStart))};
+        if (lineEnd == nullptr)
+        {
+            lineEnd = fileEnd;
+        }
+
+        off_t lineLength {lineEnd - lineStart};
+        if (lineLength > 0 && lineStart[lineLength - 1] == '\r')
+        {
+            --lineLength;
+        }
+
+        std::string_view lineView(lineStart, lineLength);
+        ++lineNumber;
+
+        // One automaton pass for all queries
+        prefilter.scan(lineView, [&](uint32_t literal, size_t) {
+            candidateEpoch[literalOwner[literal]] = lineNumber;
+            return true;
+        });
+
+        // Per-line timestamp cache shared by all queries
+        bool timestampParsed {false};
+        std::optional<std::chrono::system_clock::time_point> timestamp;
+
+        for (uint32_t q = 0; q < queries.size(); ++q)
+        {
+            BatchQuery& query {*queries[q]};
+            bool candidate {query.alwaysCandidate || candidateEpoch[q] == lineNumber};
+
+            if (!candidate && !query.writer->wants_other_lines())
+            {
+                continue;
+            }
+
+            // Date filtering: out-of-range lines are invisible to this query (also as context)
+            if (query.hasDateFilter)
+            {
+                if (!timestampParsed)
+                {
+                    timestamp = extract_timestamp(lineView, dateFormat);
+                    timestampParsed = true;
+                    linesWithTimestamps += timestamp.has_value();
+                }
+                if (timestamp && ((query.options.fromTime && *timestamp < *query.options.fromTime)
+                                  || (query.options.toTime && *timestamp > *query.options.toTime)))
+                {
+                    continue;
+                }
+            }
+
+            bool found {candidate && query.matcher.matches(lineView)};
+            LogLevel level {LogLevel::UNKNOWN};
+            if (found)
+            {
+                level = detect_log_level(lineView, query.options.logFormat);
+                found = level_in_mask(level, query.options.levelMask);
+            }
+
+            if (found)
+            {
+                query.writer->write_match(lineNumber, lineView, level);
+            }
+            else if (query.writer->wants_other_lines())
+            {
+                query.writer->write_other(lineNumber, lineView);
+            }
+        }
+
+        lineStart = lineEnd + (lineEnd < fileEnd ? 1 : 0);
+    }
+
+    if (anyDateFilter && linesWithTimestamps == 0)
+    {
+        std::cerr << '\n';
+        std::cerr << "Warning: Date filtering was requested, but no valid timestamps were found in the log lines." << std::endl;
+    }
+
+    // Per-query summary in each query's own destination
+    for (uint32_t q = 0; q < queries.size(); ++q)
+    {
+        BatchQuery& query {*queries[q]};
+        std::ostream& out {query.writer->stream()};
+
+        query.writer->finish();
+        if (query.writer->structured())
+        {
+            out.flush();
+            continue;
+        }
+
+        out << '\n';
+        if (query.options.outputFilePath.empty())
+        {
+            out << "Query " << q + 1 << ": ";
+        }
+        out << "Total Matches: " << query.writer->match_count() << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
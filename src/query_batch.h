@@ -0,0 +1,46 @@
+// src/query_batch.h
+
+#ifndef QUERY_BATCH_H
+#define QUERY_BATCH_H
+
+#include "arg_parser.h"
+#include <string>
+#include <vector>
+
+/**
+ * Splits one query-file line into arguments.
+ * Whitespace separates arguments; "double" or 'single' quotes group them.
+ * Inside double quotes \" and \\ are unescaped, every other backslash is kept
+ * (so regexes like "\d+" need no extra escaping).
+ *
+ * @param line Query line.
+ * @return Arguments in order.
+ * @throws std::runtime_error on an unterminated quote.
+ */
+std::vector<std::string> split_query_line(const std::string& line);
+
+/**
+ * Batch mode (--query-file): runs many queries against one shared scan of the file.
+ *
+ * Each non-empty, non-# line of the query file is a full query using the normal
+ * command-line syntax without the input file (patterns, -i, -r, -from, -to,
+ * --level, -A/-B/-C, -f, -o). Every query keeps its own destination, context
+ * state and match counter. Queries that share stdout prefix their lines with
+ * "[Qn] " (n = query number); two queries cannot write to the same -o file.
+ *
+ * ALGORITHM OVERVIEW:
+ * 1. Memory-map the log file once.
+ * 2. Merge the required literals of all queries into one case-folded
+ *    Aho-Corasick automaton (shared prefilter).
+ * 3. Per line: one automaton pass marks candidate queries; only candidates
+ *    (plus queries without a usable literal) run their own exact matcher.
+ *    Timestamps and log levels are computed at most once per line.
+ * 4. Queries with context lines still see every line for their ring buffers.
+ *
+ * @param options Parsed program options (inputFilePath, queryFilePath).
+ * @return EXIT_SUCCESS on completion.
+ * @throws std::runtime_error on file errors or invalid query lines.
+ */
+int run_query_file(const ProgramOptions& options);
+
+#endif // QUERY_BATCH_H
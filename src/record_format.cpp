@@ -0,0 +1,177 @@
+// src/record_format.cpp
+
+#include "record_format.h"
+#include <charconv>
+#include <limits>
+
+namespace
+{
+    constexpr char HEX_DIGITS[] {"0123456789abcdef"};
+
+    template <typename T>
+    void append_number(std::string& buffer, T value)
+    {
+        char digits[24];
+        auto [end, error] = std::to_chars(digits, digits + sizeof(digits), value);
+        buffer.append(digits, end);
+    }
+
+    // Length of the well-formed UTF-8 sequence starting at text[i] (a byte >= 0x80),
+    // or 0 if it is invalid: stray continuation, overlong, surrogate, > U+10FFFF or truncated
+    size_t utf8_sequence_length(std::string_view text, size_t i)
+    {
+        auto byte = [&](size_t k) { return static_cast<unsigned char>(text[i + k]); };
+        unsigned char lead {byte(0)};
+
+        size_t length {0};
+        unsigned char secondMin {0x80};
+        unsigned char secondMax {0xBF};
+        if (lead >= 0xC2 && lead <= 0xDF)      { length = 2; }
+        else if (lead == 0xE0)                 { length = 3; secondMin = 0xA0; }
+        else if (lead == 0xED)                 { length = 3; secondMax = 0x9F; }
+        else if (lead >= 0xE1 && lead <= 0xEF) { length = 3; }
+        else if (lead == 0xF0)                 { length = 4; secondMin = 0x90; }
+        else if (lead == 0xF4)                 { length = 4; secondMax = 0x8F; }
+        else if (lead >= 0xF1 && lead <= 0xF3) { length = 4; }
+        else                                   { return 0; }
+
+        if (text.size() - i < length || byte(1) < secondMin || byte(1) > secondMax)
+        {
+            return 0;
+        }
+        for (size_t k = 2; k < length; ++k)
+        {
+            if ((byte(k) & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+        }
+        return length;
+    }
+
+    // Escapes '"', '\\' and control characters and replaces invalid UTF-8 bytes with
+    // U+FFFD; unescaped runs are appended in bulk
+    void append_json_string(std::string& buffer, std::string_view text)
+    {
+        buffer += '"';
+
+        size_t runStart {0};
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            unsigned char c {static_cast<unsigned char>(text[i])};
+            if (c >= 0x80)
+            {
+                if (size_t length {utf8_sequence_length(text, i)}; length != 0)
+                {
+                    i += length - 1;
+                    continue;
+                }
+
+                buffer.append(text.data() + runStart, i - runStart);
+                runStart = i + 1;
+                buffer += "\xEF\xBF\xBD";
+                continue;
+            }
+            if (c >= 0x20 && c != '"' && c != '\\')
+            {
+                continue;
+            }
+
+            buffer.append(text.data() + runStart, i - runStart);
+            runStart = i + 1;
+
+            switch (c)
+            {
+                case '"':  buffer += "\\\""; break;
+                case '\\': buffer += "\\\\"; break;
+                case '\n': buffer += "\\n"; break;
+                case '\r': buffer += "\\r"; break;
+                case '\t': buffer += "\\t"; break;
+                default:
+                    buffer += "\\u00";
+                    buffer += HEX_DIGITS[c >> 4];
+                    buffer += HEX_DIGITS[c & 0xF];
+                    break;
+            }
+        }
+
+        buffer.append(text.data() + runStart, text.size() - runStart);
+        buffer += '"';
+    }
+
+    template <typename T>
+    void append_little_endian(std::string& buffer, T value)
+    {
+        auto bits {static_cast<std::make_unsigned_t<T>>(value)};
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            buffer += static_cast<char>((bits >> (8 * i)) & 0xFF);
+        }
+    }
+}
+
+void append_jsonl_record(std::string& buffer, const MatchRecord& record)
+{
+    bool match {record.kind == RecordKind::MATCH};
+
+    buffer += match ? "{\"type\":\"match\",\"line\":" : "{\"type\":\"context\",\"line\":";
+    append_number(buffer, record.lineNumber);
+    buffer += ",\"offset\":";
+    append_number(buffer, record.offset);
+
+    if (match)
+    {
+        buffer += ",\"level\":\"";
+        buffer += get_log_level_name(record.level);
+        buffer += '"';
+    }
+
+    buffer += ",\"ts\":";
+    if (record.timestampNs)
+        append_number(buffer, *record.timestampNs);
+    else
+        buffer += "null";
+
+    if (match)
+    {
+        buffer += ",\"pattern\":";
+        append_number(buffer, record.patternIndex);
+        buffer += ",\"spans\":[";
+        for (size_t i = 0; i < record.spans.size(); ++i)
+        {
+            buffer += i == 0 ? "[" : ",[";
+            append_number(buffer, record.spans[i].begin);
+            buffer += ',';
+            append_number(buffer, record.spans[i].end);
+            buffer += ']';
+        }
+        buffer += ']';
+    }
+
+    buffer += ",\"text\":";
+    append_json_string(buffer, record.line);
+    buffer += "}\n";
+}
+
+void append_binary_record(std::string& buffer, const MatchRecord& record)
+{
+    size_t bodySize {1 + 1 + 4 + 8 + 8 + 8 + 4 + record.spans.size() * 8 + 4 + record.line.size()};
+
+    append_little_endian(buffer, static_cast<uint32_t>(bodySize));
+    append_little_endian(buffer, static_cast<uint8_t>(record.kind));
+    append_little_endian(buffer, static_cast<uint8_t>(record.level));
+    append_little_endian(buffer, static_cast<int32_t>(record.patternIndex));
+    append_little_endian(buffer, record.lineNumber);
+    append_little_endian(buffer, record.offset);
+    append_little_endian(buffer, record.timestampNs.value_or(std::numeric_limits<int64_t>::min()));
+
+    append_little_endian(buffer, static_cast<uint32_t>(record.spans.size()));
+    for (const auto& span : record.spans)
+    {
+        append_little_endian(buffer, span.begin);
+        append_little_endian(buffer, span.end);
+    }
+
+    append_little_endian(buffer, static_cast<uint32_t>(record.line.size()));
+    buffer.append(record.line);
+}
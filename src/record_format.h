@@ -0,0 +1,69 @@
+// src/record_format.h
+
+#ifndef RECORD_FORMAT_H
+#define RECORD_FORMAT_H
+
+#include "matcher.h"
+#include "utils.h"
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+constexpr size_t RECORD_BUFFER_SIZE {64 * 1024}; // records are batched and written in chunks of this size
+
+enum class RecordKind : uint8_t
+{
+    MATCH = 1,
+    CONTEXT = 2  // -A/-B/-C line around a match
+};
+
+/**
+ * One output line of a search in structured form (--output jsonl|binary).
+ * Views only: nothing is copied until the record is serialized.
+ */
+struct MatchRecord
+{
+    RecordKind kind {RecordKind::MATCH};
+    uint64_t lineNumber {0};
+    uint64_t offset {0};                 // byte offset of the line in the file
+    LogLevel level {LogLevel::UNKNOWN};  // UNKNOWN for context lines
+    std::optional<int64_t> timestampNs;  // epoch nanoseconds, if the line has a timestamp
+    int patternIndex {-1};               // matching pattern, -1 for context lines
+    std::span<const MatchSpan> spans;    // occurrences of that pattern in the line
+    std::string_view line;
+};
+
+/**
+ * Appends a record as one JSON object plus '\n' (JSON Lines):
+ *
+ *   {"type":"match","line":32,"offset":2841,"level":"ERROR","ts":1761035892111000000,
+ *    "pattern":0,"spans":[[24,29]],"text":"..."}
+ *   {"type":"context","line":33,"offset":2930,"ts":null,"text":"..."}
+ *
+ * Strings are escaped by hand ('"', '\\' and control characters); valid UTF-8
+ * is copied as-is and each invalid byte becomes U+FFFD. Numbers use std::to_chars.
+ *
+ * @param buffer Output buffer (appended to; capacity reused between calls).
+ * @param record Record to serialize.
+ */
+void append_jsonl_record(std::string& buffer, const MatchRecord& record);
+
+/**
+ * Appends a record in the length-prefixed binary format (all integers little endian):
+ *
+ *   u32 record length (bytes after this field)
+ *   u8  kind (RecordKind)        u8  level (LogLevel value)
+ *   i32 pattern index (-1 = context line)
+ *   u64 line number              u64 byte offset
+ *   i64 timestamp (epoch ns, INT64_MIN = none)
+ *   u32 span count, then per span: u32 begin, u32 end
+ *   u32 line length, then the line bytes
+ *
+ * @param buffer Output buffer (appended to; capacity reused between calls).
+ * @param record Record to serialize.
+ */
+void append_binary_record(std::string& buffer, const MatchRecord& record);
+
+#endif // RECORD_FORMAT_H
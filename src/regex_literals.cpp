@@ -0,0 +1,292 @@
+// src/regex_literals.cpp
+
+#include "regex_literals.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+    using LiteralSet = std::optional<std::vector<std::string>>;
+
+    constexpr size_t MAX_LITERAL_SET_SIZE {64}; // larger alternations are not worth prefiltering
+
+    // Prefer sets whose shortest literal is longest (fewer false candidates), then smaller sets
+    bool is_better(const LiteralSet& candidate, const LiteralSet& current)
+    {
+        if (!candidate)
+            return false;
+        if (!current)
+            return true;
+
+        auto shortest = [](const std::vector<std::string>& set) {
+            size_t length {SIZE_MAX};
+            for (const auto& literal : set)
+                length = std::min(length, literal.size());
+            return length;
+        };
+
+        size_t candidateLength {shortest(*candidate)};
+        size_t currentLength {shortest(*current)};
+        if (candidateLength != currentLength)
+            return candidateLength > currentLength;
+        return candidate->size() < current->size();
+    }
+
+    /*
+    * Recursive descent over the ECMAScript grammar:
+    *   alternation := sequence ('|' sequence)*
+    *   sequence    := (atom quantifier?)*
+    * Each sequence keeps the current run of adjacent literal chars and remembers
+    * the best required set seen so far.
+    */
+    class RequiredLiteralParser
+    {
+    public:
+        explicit RequiredLiteralParser(std::string_view pattern) : m_pattern {pattern} {}
+
+        LiteralSet parse()
+        {
+            LiteralSet result {parse_alternation()};
+            if (m_pos != m_pattern.size())
+                return std::nullopt; // stray ')' - should not happen for validated patterns
+            return result;
+        }
+
+    private:
+        enum class AtomKind { CHAR, GROUP, OTHER };
+
+        struct Atom
+        {
+            AtomKind kind {AtomKind::OTHER};
+            char ch {0};
+            LiteralSet literals;
+        };
+
+        bool at_end() const { return m_pos >= m_pattern.size(); }
+        char peek() const { return m_pattern[m_pos]; }
+
+        LiteralSet parse_alternation()
+        {
+            std::vector<std::string> combined;
+            bool usable {true};
+
+            while (true)
+            {
+                LiteralSet branch {parse_sequence()};
+                if (!branch)
+                    usable = false;
+                else if (usable)
+                    combined.insert(combined.end(), branch->begin(), branch->end());
+
+                if (!at_end() && peek() == '|')
+                {
+                    ++m_pos;
+                    continue;
+                }
+                break;
+            }
+
+            if (!usable || combined.empty())
+                return std::nullopt;
+
+            std::sort(combined.begin(), combined.end());
+            combined.erase(std::unique(combined.begin(), combined.end()), combined.end());
+            if (combined.size() > MAX_LITERAL_SET_SIZE)
+                return std::nullopt;
+            return combined;
+        }
+
+        LiteralSet parse_sequence()
+        {
+            LiteralSet best;
+            std::string run;
+
+            auto flush = [&]() {
+                if (!run.empty())
+                {
+                    LiteralSet single {std::vector<std::string> {run}};
+                    if (is_better(single, best))
+                        best = std::move(single);
+                    run.clear();
+                }
+            };
+
+            while (!at_end() && peek() != '|' && peek() != ')')
+            {
+                Atom atom {parse_atom()};
+                auto [quantified, minRepeat] = parse_quantifier();
+
+                switch (atom.kind)
+                {
+                    case AtomKind::CHAR:
+                        if (quantified && minRepeat == 0)
+                        {
+                            flush(); // optional char: neither side can rely on it
+                        }
+                        else
+                        {
+                            run += atom.ch;
+                            if (quantified)
+                                flush(); // repetition breaks contiguity with what follows
+                        }
+                        break;
+
+                    case AtomKind::GROUP:
+                        flush();
+                        if (!quantified || minRepeat > 0)
+                        {
+                            if (is_better(atom.literals, best))
+                                best = std::move(atom.literals);
+                        }
+                        break;
+
+                    case AtomKind::OTHER:
+                        flush();
+                        break;
+                }
+            }
+
+            flush();
+            return best;
+        }
+
+        Atom parse_atom()
+        {
+            char c {peek()};
+            ++m_pos;
+
+            switch (c)
+            {
+                case '(':
+                {
+                    bool lookaround {false};
+                    if (m_pos + 1 < m_pattern.size() && peek() == '?')
+                    {
+                        char kind {m_pattern[m_pos + 1]};
+                        lookaround = (kind == '=' || kind == '!');
+                        m_pos += 2; // "?:", "?=", "?!"
+                    }
+
+                    LiteralSet inner {parse_alternation()};
+                    if (!at_end() && peek() == ')')
+                        ++m_pos;
+
+                    if (lookaround)
+                        return {};
+                    return {AtomKind::GROUP, 0, std::move(inner)};
+                }
+
+                case '[':
+                    skip_class();
+                    return {};
+
+                case '\\':
+                    return parse_escape();
+
+                case '.': case '^': case '$':
+                    return {};
+
+                default:
+                    return {AtomKind::CHAR, c, std::nullopt};
+            }
+        }
+
+        Atom parse_escape()
+        {
+            if (at_end())
+                return {};
+
+            char c {peek()};
+            ++m_pos;
+
+            switch (c)
+            {
+                case 'n': return {AtomKind::CHAR, '\n', std::nullopt};
+                case 't': return {AtomKind::CHAR, '\t', std::nullopt};
+                case 'r': return {AtomKind::CHAR, '\r', std::nullopt};
+                case 'f': return {AtomKind::CHAR, '\f', std::nullopt};
+                case 'v': return {AtomKind::CHAR, '\v', std::nullopt};
+                default: break;
+            }
+
+            // Skip operands so they are not mistaken for literal chars
+            if (c == 'x')
+                m_pos = std::min(m_pos + 2, m_pattern.size());
+            else if (c == 'u')
+                m_pos = std::min(m_pos + 4, m_pattern.size());
+            else if (c == 'c')
+                m_pos = std::min(m_pos + 1, m_pattern.size());
+            else if (c >= '0' && c <= '9')
+                while (!at_end() && peek() >= '0' && peek() <= '9')
+                    ++m_pos;
+
+            // Classes (\d \w \s ...), assertions (\b \B), backreferences, \x \u \c escapes
+            bool alnum {(c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')};
+            if (alnum)
+                return {};
+
+            return {AtomKind::CHAR, c, std::nullopt}; // escaped punctuation: \. \( \\ ...
+        }
+
+        void skip_class()
+        {
+            // ECMAScript: "[]" is the empty class, so the first ']' always closes
+            while (!at_end() && peek() != ']')
+            {
+                if (peek() == '\\')
+                    ++m_pos;
+                ++m_pos;
+            }
+            if (!at_end())
+                ++m_pos;
+        }
+
+        // Returns {quantified, minimum repetitions}
+        std::pair<bool, int> parse_quantifier()
+        {
+            if (at_end())
+                return {false, 1};
+
+            int minRepeat {1};
+            char c {peek()};
+
+            if (c == '*' || c == '?')
+            {
+                minRepeat = 0;
+                ++m_pos;
+            }
+            else if (c == '+')
+            {
+                ++m_pos;
+            }
+            else if (c == '{')
+            {
+                size_t close {m_pattern.find('}', m_pos)};
+                if (close == std::string_view::npos)
+                    return {false, 1};
+
+                minRepeat = 0;
+                for (size_t k = m_pos + 1; k < close && m_pattern[k] >= '0' && m_pattern[k] <= '9'; ++k)
+                    minRepeat = std::min(minRepeat * 10 + (m_pattern[k] - '0'), 1000);
+                m_pos = close + 1;
+            }
+            else
+            {
+                return {false, 1};
+            }
+
+            if (!at_end() && peek() == '?')
+                ++m_pos; // lazy quantifier, same requirements
+
+            return {true, minRepeat};
+        }
+
+        std::string_view m_pattern;
+        size_t m_pos {0};
+    };
+}
+
+std::optional<std::vector<std::string>> extract_required_literals(std::string_view pattern)
+{
+    return RequiredLiteralParser(pattern).parse();
+}
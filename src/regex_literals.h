@@ -0,0 +1,29 @@
+// src/regex_literals.h
+
+#ifndef REGEX_LITERALS_H
+#define REGEX_LITERALS_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Extracts required literal factors from an ECMAScript regex.
+ * The result is a set of literals of which at least one occurs in every
+ * string the regex can match, e.g.
+ *   "ERROR.*Payment"            -> {"Payment"}   (longest required factor)
+ *   "(userId|sessionId)=\d+"    -> {"userId", "sessionId"}
+ *   "error|warning"             -> {"error", "warning"}
+ *   "\d+"                       -> std::nullopt
+ *
+ * The analysis is conservative: anything it does not understand (classes,
+ * lookarounds, backreferences, optional atoms) simply contributes no literal.
+ * With -i the literals must be compared case-insensitively.
+ *
+ * @param pattern Regex source (already validated by std::regex).
+ * @return Literal set, or std::nullopt if no usable literal exists.
+ */
+std::optional<std::vector<std::string>> extract_required_literals(std::string_view pattern);
+
+#endif // REGEX_LITERALS_H
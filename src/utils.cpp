@@ -1,8 +1,15 @@
 // src/utils.cpp
 
 #include "utils.h"
+#include <thread>
 
-LogLevel detect_log_level(const std::string& line, const LogLevelConfig& config)
+namespace
+{
+    constexpr uint64_t FNV_OFFSET_BASIS {1469598103934665603ULL};
+    constexpr uint64_t FNV_PRIME {1099511628211ULL};
+}
+
+LogLevel detect_log_level(std::string_view line, const LogLevelConfig& config)
 {
     for (const auto& keyword : config.fatalKeywords) {
         if (contains_case_insensitive(line, keyword)) {
@@ -37,6 +44,20 @@ LogLevel detect_log_level(const std::string& line, const LogLevelConfig& config)
     return LogLevel::UNKNOWN;
 }
 
+std::optional<LogLevel> parse_log_level(std::string_view name)
+{
+    std::string lowered = to_lower(std::string(name));
+
+    if (lowered == "fatal") return LogLevel::FATAL;
+    if (lowered == "error") return LogLevel::ERROR;
+    if (lowered == "warning" || lowered == "warn") return LogLevel::WARNING;
+    if (lowered == "info") return LogLevel::INFO;
+    if (lowered == "debug") return LogLevel::DEBUG;
+    if (lowered == "unknown") return LogLevel::UNKNOWN;
+
+    return std::nullopt;
+}
+
 const char* get_log_level_color(LogLevel level)
 {
     switch (level) {
@@ -55,6 +76,24 @@ const char* get_log_level_color(LogLevel level)
     }
 }
 
+const char* get_log_level_name(LogLevel level)
+{
+    switch (level) {
+        case LogLevel::FATAL:
+            return "FATAL";
+        case LogLevel::ERROR:
+            return "ERROR";
+        case LogLevel::WARNING:
+            return "WARNING";
+        case LogLevel::INFO:
+            return "INFO";
+        case LogLevel::DEBUG:
+            return "DEBUG";
+        default:
+            return "UNKNOWN";
+    }
+}
+
 std::string to_lower(const std::string& str)
 {
     std::string result = str;
@@ -71,4 +110,26 @@ bool contains_case_insensitive(std::string_view haystack, std::string_view needl
                         [](char ch1, char ch2) { return std::tolower(ch1) == std::tolower(ch2); });
 
     return it != haystack.end();
-}
\ No newline at end of file
+}
+
+size_t resolve_thread_count(int requested)
+{
+    if (requested > 0)
+    {
+        return static_cast<size_t>(requested);
+    }
+
+    unsigned int hardware {std::thread::hardware_concurrency()};
+    return hardware == 0 ? 1 : hardware;
+}
+
+uint64_t fnv1a_hash(std::string_view text)
+{
+    uint64_t hash {FNV_OFFSET_BASIS};
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
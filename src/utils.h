@@ -4,8 +4,11 @@
 #define UTILS_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <algorithm>
+#include <optional>
+#include <cstdint>
 
 // ANSI color codes for terminal text formatting
 constexpr const char* RED_COLOR = "\033[31m";
@@ -25,12 +28,27 @@ enum class LogLevel {
     UNKNOWN
 };
 
+// Bit set of log levels (--level filter), one bit per LogLevel value
+constexpr unsigned ALL_LOG_LEVELS_MASK {(1u << (static_cast<unsigned>(LogLevel::UNKNOWN) + 1)) - 1};
+
+constexpr unsigned log_level_bit(LogLevel level)
+{
+    return 1u << static_cast<unsigned>(level);
+}
+
+constexpr bool level_in_mask(LogLevel level, unsigned mask)
+{
+    return (mask & log_level_bit(level)) != 0;
+}
+
 struct LogLevelConfig {
     std::vector<std::string> fatalKeywords;
     std::vector<std::string> errorKeywords;
     std::vector<std::string> warningKeywords;
     std::vector<std::string> infoKeywords;
     std::vector<std::string> debugKeywords;
+
+    bool operator==(const LogLevelConfig&) const = default;
 };
 
 namespace LogFormats {
@@ -78,7 +96,15 @@ inline const LogLevelConfig& DEFAULT_LOG_LEVEL_CONFIG = LogFormats::GENERIC;
  * @param config Keyword patterns for each log level.
  * @return Detected log level, or UNKNOWN if none matched.
  */
-LogLevel detect_log_level(const std::string& line, const LogLevelConfig& config);
+LogLevel detect_log_level(std::string_view line, const LogLevelConfig& config);
+
+/**
+ * Parses a log level name (case-insensitive): fatal, error, warning/warn, info, debug, unknown.
+ * 
+ * @param name Level name.
+ * @return Matching level, or std::nullopt if the name is not recognized.
+ */
+std::optional<LogLevel> parse_log_level(std::string_view name);
 
 /**
  * Map log level to corresponding ANSI color code (for terminal output).
@@ -89,6 +115,14 @@ LogLevel detect_log_level(const std::string& line, const LogLevelConfig& config)
  */
 const char* get_log_level_color(LogLevel level);
 
+/**
+ * Upper-case name of a log level ("FATAL", "ERROR", "WARNING", "INFO", "DEBUG", "UNKNOWN").
+ * 
+ * @param level Log level enum.
+ * @return Static string (must not be freed).
+ */
+const char* get_log_level_name(LogLevel level);
+
 /**
  * Converts a string to lowercase.
  * 
@@ -107,4 +141,21 @@ std::string to_lower(const std::string& str);
  */
 bool contains_case_insensitive(std::string_view haystack, std::string_view needle);
 
+/**
+ * Resolves the worker thread count requested with --threads.
+ * 0 means "auto" (one per hardware thread).
+ *
+ * @param requested Value given on the command line.
+ * @return Thread count to use (always >= 1).
+ */
+size_t resolve_thread_count(int requested);
+
+/**
+ * 64-bit FNV-1a hash (fast, non-cryptographic).
+ *
+ * @param text Bytes to hash.
+ * @return Hash value.
+ */
+uint64_t fnv1a_hash(std::string_view text);
+
 #endif // UTILS_H
\ No newline at end of file
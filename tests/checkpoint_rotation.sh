@@ -0,0 +1,62 @@
+#!/bin/sh
+# tests/checkpoint_rotation.sh
+# Incremental runs (--checkpoint --since-last) over appends, an unterminated
+# last line and a mv-style rotation must report every line exactly once.
+# Usage: tests/checkpoint_rotation.sh <logparser binary>
+
+set -eu
+
+BINARY=${1:-./logparser}
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+LOG="$WORK_DIR/app.log"
+STATE="$WORK_DIR/app.state"
+
+append() {
+    for n in "$@"; do
+        printf '2025-10-21 08:00:%02d [INFO] event %d\n' "$n" "$n" >> "$LOG"
+    done
+}
+
+run() {
+    "$BINARY" "$LOG" event --checkpoint "$STATE" --since-last >> "$WORK_DIR/output.txt"
+}
+
+append 1 2 3 4 5
+run
+
+append 6 7 8
+printf '2025-10-21 08:00:09 [INFO] event 9' >> "$LOG" # unterminated: left for the next run
+run
+
+printf '\n' >> "$LOG"
+append 10 11
+mv "$LOG" "$LOG.1"                                      # rotation: the rest of app.log.1 is read first
+append 12 13 14
+run
+
+append 15
+run
+run                                                     # nothing new
+
+grep -o 'event [0-9]*' "$WORK_DIR/output.txt" | sort | uniq -c > "$WORK_DIR/counts.txt"
+
+FAILED=0
+for n in $(seq 1 15); do
+    count=$(awk -v line="event $n" '$2 " " $3 == line { print $1 }' "$WORK_DIR/counts.txt")
+    if [ "${count:-0}" != "1" ]; then
+        echo "FAIL: 'event $n' reported ${count:-0} times" >&2
+        FAILED=1
+    fi
+done
+if [ "$(wc -l < "$WORK_DIR/counts.txt")" -ne 15 ]; then
+    echo "FAIL: unexpected lines reported" >&2
+    cat "$WORK_DIR/counts.txt" >&2
+    FAILED=1
+fi
+
+if [ "$FAILED" -ne 0 ]; then
+    exit 1
+fi
+echo "PASS: checkpoint_rotation"
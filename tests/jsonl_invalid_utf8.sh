@@ -0,0 +1,23 @@
+#!/bin/sh
+# tests/jsonl_invalid_utf8.sh
+# Invalid UTF-8 in a matched line must come out of --output jsonl as U+FFFD,
+# keeping every record valid JSON. Usage: tests/jsonl_invalid_utf8.sh <logparser binary>
+
+set -eu
+
+BINARY=${1:-./logparser}
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+printf '2025-10-21 08:34:42 ERROR raw \377 byte, \303\251 kept\n' > "$WORK_DIR/input.log"
+
+"$BINARY" "$WORK_DIR/input.log" ERROR --output jsonl > "$WORK_DIR/output.jsonl"
+
+EXPECTED=$(printf '"text":"2025-10-21 08:34:42 ERROR raw \357\277\275 byte, \303\251 kept"')
+if ! grep -qF "$EXPECTED" "$WORK_DIR/output.jsonl"; then
+    echo "FAIL: invalid UTF-8 byte not replaced with U+FFFD" >&2
+    cat "$WORK_DIR/output.jsonl" >&2
+    exit 1
+fi
+
+echo "PASS: jsonl_invalid_utf8"
@@ -0,0 +1,54 @@
+#!/bin/sh
+# tests/pack_roundtrip.sh
+# Searching an .lpk archive must print exactly what searching the original log
+# prints, including context across block boundaries and -from/-to block skipping.
+# Usage: tests/pack_roundtrip.sh <logparser binary>
+
+set -eu
+
+BINARY=${1:-./logparser}
+WORK_DIR=$(mktemp -d)
+trap 'rm -rf "$WORK_DIR"' EXIT
+
+# ~11 MB (three 4 MB blocks): ISO-8601 UTC timestamps 500 ms apart, levels in
+# rotation and an undated stack trace line after every 7th line
+awk 'BEGIN {
+    split("INFO DEBUG WARN ERROR INFO FATAL", levels, " ");
+    for (i = 0; i < 150000; i++) {
+        ms = i * 500;
+        printf "2025-10-21T%02d:%02d:%02d.%03dZ [%s] worker-%d request %d took %dms\n",
+               int(ms / 3600000), int(ms / 60000) % 60, int(ms / 1000) % 60, ms % 1000,
+               levels[i % 6 + 1], i % 13, i, (i * 7919) % 5000;
+        if (i % 7 == 0)
+            printf "    at com.example.Worker.run(Worker.java:%d)\n", i % 97;
+    }
+}' > "$WORK_DIR/input.log"
+
+"$BINARY" pack "$WORK_DIR/input.log" "$WORK_DIR/input.lpk" > /dev/null
+
+FAILED=0
+check() {
+    "$BINARY" "$WORK_DIR/input.log" "$@" > "$WORK_DIR/expected.txt" 2>&1 || true
+    "$BINARY" "$WORK_DIR/input.lpk" "$@" > "$WORK_DIR/actual.txt" 2>&1 || true
+    if ! cmp -s "$WORK_DIR/expected.txt" "$WORK_DIR/actual.txt"; then
+        echo "FAIL: pack search differs for: $*" >&2
+        diff "$WORK_DIR/expected.txt" "$WORK_DIR/actual.txt" | head -5 >&2
+        FAILED=1
+    fi
+}
+
+check ERROR
+check "request 7" -C 2
+check Worker.java -B 3 -A 1
+check took --level fatal
+check "took [0-9]+ms" -r --level error,warn -C 1
+check ERROR -from "2025-10-21T06:00:00Z" -to "2025-10-21T06:30:00Z"
+check worker-3 -from "2025-10-21T12:00:00Z" -C 2
+check nothingmatches -from "2030-01-01T00:00:00Z"
+check FATAL --output jsonl
+check "request 99" -C 1 --output binary
+
+if [ "$FAILED" -ne 0 ]; then
+    exit 1
+fi
+echo "PASS: pack_roundtrip"
@@ -0,0 +1,158 @@
+// tests/regex_literals_test.cpp
+//
+// Table tests for extract_required_literals(): the extracted set must be the
+// expected one, and every line std::regex_search() matches must contain one of
+// its literals (otherwise the buffer prefilter would silently drop matches).
+
+#include "../src/regex_literals.h"
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <optional>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct LiteralCase
+    {
+        std::string pattern;
+        bool caseInsensitive {false};
+        std::optional<std::vector<std::string>> expected; // sorted; std::nullopt = no usable literal
+        std::vector<std::string> lines;
+    };
+
+    using Literals = std::vector<std::string>;
+
+    const std::vector<LiteralCase> CASES {
+        // Plain sequences: the longest required factor
+        {"ERROR.*Payment", false, Literals {"Payment"}, {"ERROR Payment declined", "ERROR x", "Payment ok ERROR"}},
+        {"timeout after \\d+ms", false, Literals {"timeout after "}, {"timeout after 30ms", "timeout after ms"}},
+
+        // Alternation
+        {"error|warning", false, Literals {"error", "warning"}, {"an error", "a warning", "neither"}},
+        {"(userId|sessionId)=\\d+", false, Literals {"sessionId", "userId"}, {"userId=42", "sessionId=7", "orderId=1"}},
+        {"a(bc|de)f", false, Literals {"bc", "de"}, {"abcf", "adef", "af"}},
+        {"error|", false, std::nullopt, {"anything", ""}},
+        {"(foo|.*)bar", false, Literals {"bar"}, {"xbar", "foobar", "ba"}},
+
+        // Optional groups and chars
+        {"colou?r", false, Literals {"colo"}, {"color", "colour", "colr"}},
+        {"(Fatal )?Error: disk", false, Literals {"Error: disk"}, {"Fatal Error: disk", "Error: disk", "Error:disk"}},
+        {"(abc)*", false, std::nullopt, {"", "abc", "x"}},
+        {"x(abc){0}y", false, Literals {"x"}, {"xy", "xabcy"}},
+        {"(abc){2,}", false, Literals {"abc"}, {"abcabc", "abc"}},
+        {"ab+c", false, Literals {"ab"}, {"abbbc", "ac", "abc"}},
+
+        // Classes
+        {"[A-Z]+ failed", false, Literals {" failed"}, {"JOB failed", "job failed", "failed"}},
+        {"[]a]bc", false, Literals {"a]bc"}, {"a]bc", "abc"}}, // ECMAScript: "[]" is the empty class
+        {"x[\\]y]z", false, Literals {"x"}, {"x]z", "xyz", "xz"}},
+        {"[^0-9]+", false, std::nullopt, {"abc", "123"}},
+
+        // Escapes
+        {"a\\.b", false, Literals {"a.b"}, {"a.b", "axb"}},
+        {"\\(id\\)", false, Literals {"(id)"}, {"(id)", "id"}},
+        {"path\\\\to", false, Literals {"path\\to"}, {"path\\to", "pathto"}},
+        {"tab\\there", false, Literals {"tab\there"}, {"tab\there", "tab here"}},
+        {"\\x41BC", false, Literals {"BC"}, {"ABC", "BC"}},
+        {"\\u0041BC", false, Literals {"BC"}, {"ABC"}},
+        {"\\bword\\b", false, Literals {"word"}, {"a word here", "swordfish"}},
+        {"\\d+", false, std::nullopt, {"123", "abc"}},
+        {"\\w+@\\w+", false, Literals {"@"}, {"me@host", "no at"}},
+
+        // Backreferences
+        {"(ab)\\1", false, Literals {"ab"}, {"abab", "ab"}},
+        {"(a|b)x\\1y", false, Literals {"x"}, {"axay", "bxby", "cxcy"}},
+
+        // Lookarounds contribute nothing
+        {"(?=abc)abd|xyz", false, Literals {"abd", "xyz"}, {"abd", "xyz"}},
+        {"foo(?!bar)", false, Literals {"foo"}, {"foobaz", "foobar"}},
+        {"(?:non)capture", false, Literals {"capture"}, {"noncapture", "capture"}},
+
+        // Case-insensitive (-i): literals are compared case-folded
+        {"error.*timeout", true, Literals {"timeout"}, {"ERROR: TIMEOUT", "Error TimeOut", "error"}},
+        {"(WARN|Info)ing", true, Literals {"Info", "WARN"}, {"warning", "INFOING", "debug"}},
+
+        // Nothing required
+        {".*", false, std::nullopt, {"", "x"}},
+        {"^$", false, std::nullopt, {"", "x"}},
+        {"a?b?c?", false, std::nullopt, {"", "abc"}},
+        {"[abc]", false, std::nullopt, {"a", "d"}},
+    };
+
+    std::string fold(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+        return text;
+    }
+
+    bool contains_any(const std::string& line, const std::vector<std::string>& literals, bool caseInsensitive)
+    {
+        for (const auto& literal : literals)
+        {
+            bool found {caseInsensitive ? fold(line).find(fold(literal)) != std::string::npos
+                                        : line.find(literal) != std::string::npos};
+            if (found)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string describe(const std::optional<std::vector<std::string>>& literals)
+    {
+        if (!literals)
+        {
+            return "none";
+        }
+        std::string text {"{"};
+        for (const auto& literal : *literals)
+        {
+            text += (text.size() > 1 ? ", \"" : "\"") + literal + "\"";
+        }
+        return text + "}";
+    }
+}
+
+int main()
+{
+    int failures {0};
+
+    for (const auto& test : CASES)
+    {
+        auto literals {extract_required_literals(test.pattern)};
+        if (literals)
+        {
+            std::sort(literals->begin(), literals->end());
+        }
+        if (literals != test.expected)
+        {
+            std::cerr << "FAIL: /" << test.pattern << "/ extracted " << describe(literals)
+                      << ", expected " << describe(test.expected) << '\n';
+            ++failures;
+        }
+
+        // The property the prefilter relies on, checked against the real regex engine
+        std::regex regex(test.pattern, test.caseInsensitive ? std::regex::icase : std::regex::ECMAScript);
+        for (const auto& line : test.lines)
+        {
+            if (literals && std::regex_search(line, regex) && !contains_any(line, *literals, test.caseInsensitive))
+            {
+                std::cerr << "FAIL: /" << test.pattern << "/ matches \"" << line
+                          << "\" which contains none of " << describe(literals) << '\n';
+                ++failures;
+            }
+        }
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << failures << " failure(s)\n";
+        return 1;
+    }
+    std::cout << "PASS: regex_literals (" << CASES.size() << " patterns)\n";
+    return 0;
+}